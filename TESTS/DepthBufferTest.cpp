@@ -235,7 +235,7 @@ int main()
 	};
 
 	VkBuffer vertexBuffer = NULL;
-	VkDeviceMemory vertexBufferMem = NULL;
+	val::memoryAllocation vertexBufferMem;
 	proc.createVertexBuffer(vertices.data(), vertices.size(), sizeof(val::vertex3D), &vertexBuffer, &vertexBufferMem);
 
 	std::vector<uint32_t> indices = {
@@ -244,7 +244,7 @@ int main()
 	};
 
 	VkBuffer indexBuffer = NULL;
-	VkDeviceMemory indexBufferMem = NULL;
+	val::memoryAllocation indexBufferMem;
 	proc.createIndexBuffer(indices.data(), indices.size(), &indexBuffer, &indexBufferMem);
 
 	proc.createDescriptorSets(&pipeline);
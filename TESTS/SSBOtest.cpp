@@ -218,8 +218,8 @@ int main() {
 	// it would be nice if there was a simpler way to do this...
 	for (size_t i = 0; i < proc._MAX_FRAMES_IN_FLIGHT; i++) {
 		VkDescriptorBufferInfo storageBufferInfoLastFrame{};
-		storageBufferInfoLastFrame.buffer = ssboHdl.getBuffers(proc)[(i - 1) % proc._MAX_FRAMES_IN_FLIGHT];
-		storageBufferInfoLastFrame.offset = 0;
+		storageBufferInfoLastFrame.buffer = ssboHdl.getBuffer(proc);
+		storageBufferInfoLastFrame.offset = ssboHdl.getOffset((i - 1) % proc._MAX_FRAMES_IN_FLIGHT);
 		storageBufferInfoLastFrame.range = sizeof(Particle) * PARTICLE_COUNT;
 
 		std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
@@ -232,8 +232,8 @@ int main() {
 		descriptorWrites[0].pBufferInfo = &storageBufferInfoLastFrame;
 
 		VkDescriptorBufferInfo storageBufferInfoCurrentFrame{};
-		storageBufferInfoCurrentFrame.buffer = ssboHdl.getBuffers(proc)[i];
-		storageBufferInfoCurrentFrame.offset = 0;
+		storageBufferInfoCurrentFrame.buffer = ssboHdl.getBuffer(proc);
+		storageBufferInfoCurrentFrame.offset = ssboHdl.getOffset(i);
 		storageBufferInfoCurrentFrame.range = sizeof(Particle) * PARTICLE_COUNT;
 
 		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -288,8 +288,8 @@ int main() {
 		updateUniformBuffer(proc, uboHDL);
 
 
-		// note: the getBuffers function is very ineffecient, it should be omptimized.
-		renderTarget.setVertexBuffers({ ssboHdl.getBuffers(proc)[proc._currentFrame] }, PARTICLE_COUNT);
+		// every frame of the SSBO is a range of the same buffer
+		renderTarget.setVertexBuffer(ssboHdl.getBuffer(proc), ssboHdl.getOffset(proc._currentFrame), PARTICLE_COUNT);
 		// the renderTarget must be updated after any changes are made 
 		VkFramebuffer framebuffer = window.beginDraw(imageFormat);
 
@@ -306,7 +306,7 @@ int main() {
 		double currentTime = glfwGetTime();
 		lastFrameTime = (currentTime - lastTime) * 1000.0;
 
-		//glm::vec2* debugData = (glm::vec2*)(proc._SSBO_DataMapped[currentFrame][debugHdl._index]);
+		//glm::vec2* debugData = (glm::vec2*)(debugHdl.getData(proc, currentFrame));
 		//printf("DEBUG BUFFER: x: %f y: %f\n", debugData->x, debugData->y);
 	}
 
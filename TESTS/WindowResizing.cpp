@@ -200,14 +200,14 @@ int main() {
 	};
 
 	VkBuffer vertexBuffer = NULL;
-	VkDeviceMemory vertexBufferMem = NULL;
+	val::memoryAllocation vertexBufferMem;
 	mainProc.createVertexBuffer(vertices.data(), vertices.size(), sizeof(res::vertex), &vertexBuffer, &vertexBufferMem);
 
 
 	std::vector<uint32_t> indices = {
 		0, 1, 2, 2, 3, 0 };
 	VkBuffer indexBuffer = NULL;
-	VkDeviceMemory indexBufferMem = NULL;
+	val::memoryAllocation indexBufferMem;
 	mainProc.createIndexBuffer(indices.data(), indices.size(), &indexBuffer, &indexBufferMem);
 	//mainProc.render();
 	//mainProc.display(window.getHandleGLFW());
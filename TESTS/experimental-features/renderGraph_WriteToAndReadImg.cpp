@@ -233,7 +233,7 @@ int main()
 		/* * * * * * * * * * * * * * * * * */
 
 		RESET_COMMAND_BUFFER(cmd);
-		BEGIN_COMMAND_BUFFER(cmd);
+		BEGIN_COMMAND_BUFFER(proc, cmd);
 
 		BEGIN_RENDER_PASS(passContext, pipeline, framebuffer, cmd, FIXED);
 
@@ -190,14 +190,14 @@ int main() {
 
 
 	VkBuffer vertexBuffer = NULL;
-	VkDeviceMemory vertexBufferMem = NULL;
+	val::memoryAllocation vertexBufferMem;
 	mainProc.createVertexBuffer(vertices, vertexCount, sizeof(polygonVertex), &vertexBuffer, &vertexBufferMem);
 
 
 	
 
 	VkBuffer indexBuffer = NULL;
-	VkDeviceMemory indexBufferMem = NULL;
+	val::memoryAllocation indexBufferMem;
 	mainProc.createIndexBuffer(indices, indicesCount, &indexBuffer, &indexBufferMem);
 
 
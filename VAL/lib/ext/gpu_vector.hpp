@@ -75,7 +75,7 @@ namespace val {
 	public:
 
 		inline VkDeviceMemory& getVkDeviceMemory() {
-			return _memory;
+			return _memory.memory;
 		}
 
 		inline VkBuffer& getVkBuffer() {
@@ -91,14 +91,14 @@ namespace val {
 
 			proc.createBuffer(buffSzeInbytes, _usage, bufferSpaceToVkMemoryProperty(CPU_GPU), _buffer, _memory);
 
-			vkMapMemory(proc._device, _memory, 0, _size, 0, (void**)&_mappedMemory);
+			_mappedMemory = (T*)_memory.mapped;
 		}
 
 		inline void resize(VAL_PROC& proc, const size_t& newSize) {
 			if (_size == newSize) { return; }
 
 			VkBuffer newBuffer;
-			VkDeviceMemory newMemory;
+			memoryAllocation newMemory;
 
 			size_t tmp_capacity = roundToNextPowerOfTwo(newSize + 1);
 
@@ -112,10 +112,7 @@ namespace val {
 
 				// destroy the old buffer
 				if (_memory) {
-					vkFreeMemory(proc._device, _memory, VK_NULL_HANDLE);
-					vkDestroyBuffer(proc._device, _buffer, VK_NULL_HANDLE);
-					_memory = VK_NULL_HANDLE;
-					_buffer = VK_NULL_HANDLE;
+					proc.destroyBuffer(_buffer, _memory);
 				}
 					
 				_memory = newMemory;
@@ -124,7 +121,7 @@ namespace val {
 				_size = newSize;
 				_capacity = tmp_capacity;
 
-				vkMapMemory(proc._device, _memory, 0, _size, 0, (void**)& _mappedMemory);
+				_mappedMemory = (T*)_memory.mapped;
 			}
 		}
 
@@ -132,7 +129,7 @@ namespace val {
 			if (_size == newSize) { return; }
 
 			VkBuffer newBuffer;
-			VkDeviceMemory newMemory;
+			memoryAllocation newMemory;
 
 			size_t tmp_capacity = roundToNextPowerOfTwo(newSize + 1);
 
@@ -146,10 +143,7 @@ namespace val {
 
 				// destroy the old buffer
 				if (_memory) {
-					vkFreeMemory(proc._device, _memory, VK_NULL_HANDLE);
-					vkDestroyBuffer(proc._device, _buffer, VK_NULL_HANDLE);
-					_memory = VK_NULL_HANDLE;
-					_buffer = VK_NULL_HANDLE;
+					proc.destroyBuffer(_buffer, _memory);
 				}
 
 				_memory = newMemory;
@@ -158,7 +152,7 @@ namespace val {
 				_size = newSize;
 				_capacity = tmp_capacity;
 
-				vkMapMemory(proc._device, _memory, 0, _size, 0, &_mappedMemory);
+				_mappedMemory = (T*)_memory.mapped;
 			}
 		}
 
@@ -195,12 +189,10 @@ namespace val {
 
 		inline void destroy(VAL_PROC& proc) {
 			if (_memory) {
-				vkDestroyBuffer(proc._device, _buffer, VK_NULL_HANDLE);
-				vkFreeMemory(proc._device, _memory, VK_NULL_HANDLE);
+				proc.destroyBuffer(_buffer, _memory);
 				_size = 0u;
 				_capacity = 0u;
 				_mappedMemory = NULL;
-				_memory = NULL;
 			}
 		}
 
@@ -230,7 +222,7 @@ namespace val {
 		}
 
 		const VkDeviceMemory& getVkMemory() const {
-			return _memory;
+			return _memory.memory;
 		}
 
 		const VkBufferUsageFlags& getUsage() const {
@@ -241,7 +233,7 @@ namespace val {
 		VkBufferUsageFlags _usage = VK_BUFFER_USAGE_FLAG_BITS_MAX_ENUM;
 		size_t _capacity = 0u;
 		size_t _size = 0u;
-		VkDeviceMemory _memory = VK_NULL_HANDLE;
+		memoryAllocation _memory;
 		VkBuffer _buffer = VK_NULL_HANDLE;
 
 		T* _mappedMemory = NULL;
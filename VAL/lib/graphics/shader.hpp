@@ -29,11 +29,13 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #include <VAL/lib/system/sampler.hpp>
 
 #include <VAL/lib/system/pushDescriptor.hpp>
+#include <VAL/lib/system/shaderModuleCache.hpp>
 
 #include <optional>
 #include <string.h>
 #include <stdexcept>
 #include <filesystem>
+#include <memory>
 
 /*THE DIFFERENT TYPES OF SHADERS SUPPORTED BY VULKAN
 VK_SHADER_STAGE_VERTEX_BIT = 0x00000001,
@@ -64,7 +66,8 @@ namespace val {
 		}
 		
 	public:
-		// returns true if the shader was succesfully loaded
+		// returns true if the shader was succesfully loaded.
+		// Shaders that load the same file share it's bytecode, the file is only read again if it has been modified.
 		bool loadFromFile(fs::path filepath);
 
 		void setEntryPoint(const std::string& entryPoint);
@@ -78,16 +81,23 @@ namespace val {
 
 		const fs::path& getFilepath() noexcept;
 
+		// the bytecode may be shared with other shaders that loaded the same file
 		tiny_vector<char>& getByteCode() noexcept;
 
+		// releases the bytecode, it is freed once no other shader shares it. This is safe once the VAL_PROC has been created,
+		// the shader modules are cached by the hash of the bytecode, which doesn't keep the bytecode alive (see val::shaderModuleCache)
 		void deleteByteCode();
 
 		void setStageFlags(const VkShaderStageFlags& stageFlags);
 
 		VkShaderStageFlags getStageFlags() noexcept;
 
+		// the bindings of set 0, which are declared with DESCRIPTOR_UPDATE_RATE::PER_FRAME
 		virtual std::vector<VkDescriptorSetLayoutBinding>* getLayoutBindings() noexcept;
 
+		// the bindings that are declared with the update rate, they're in the set of that rate (see DESCRIPTOR_UPDATE_RATE)
+		virtual std::vector<VkDescriptorSetLayoutBinding>* getUpdateRateLayoutBindings(const DESCRIPTOR_UPDATE_RATE updateRate) noexcept;
+
 		virtual std::vector<VkDescriptorSetLayoutBinding>* getPushDescriptorLayoutBindings() noexcept;
 
 		virtual std::vector<VkWriteDescriptorSet>* getDescriptorWrites();
@@ -124,6 +134,9 @@ namespace val {
 		const std::vector<descriptorBinding<val::SSBO_Handle*>> getSSBOs() noexcept;
 
 	public:
+		// the update functions don't write to the descriptor sets immediately, the writes are queued and applied together by
+		// VAL_PROC::flushDescriptorWrites() when the next renderTarget or computeTarget of the written frame begins. Repeated writes to a binding only cost the last one.
+		// Static bindings are written once, into the static set that every frame in flight shares (see DESCRIPTOR_UPDATE_RATE::STATIC).
 		void updateImageSampler(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<sampler&, uint32_t> sampler);
 
 		void updateImageSamplerAtFrame(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<sampler&, uint32_t> sampler, const uint8_t frameInFlight);
@@ -140,11 +153,16 @@ namespace val {
 
 		void updateSSBOatFrame(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<SSBO_Handle, uint32_t> SSBO, const uint8_t frameInFlight, const uint16_t arrIdx = 0);
 
+	protected:
+		// appends the layout bindings of the descriptors with the update rate
+		void appendLayoutBindings(std::vector<VkDescriptorSetLayoutBinding>& bindingsOut, const DESCRIPTOR_UPDATE_RATE updateRate);
+
 	public:
 		VkShaderStageFlags _shaderStageFlags;
 
 		std::string _entryPoint = "main";
-		tiny_vector<char> _byteCode;
+		std::shared_ptr<tiny_vector<char>> _byteCode;
+		shaderModuleKey _byteCodeKey; // set when the shader module is created, identifies the module once the bytecode has been deleted
 		fs::path _filepath;
 
 		std::vector<descriptorBinding<specializationConstant*/*Constant*/>> _specializationConstants;
@@ -158,6 +176,7 @@ namespace val {
 		//std::vector<VkImageView*> _imageViews;
 
 		std::vector<VkDescriptorSetLayoutBinding> _layoutBindings;
+		std::vector<VkDescriptorSetLayoutBinding> _updateRateLayoutBindings;
 		std::vector<VkWriteDescriptorSet> _descriptorWrites; // stored as part of the class for optimization (avoids excess copying), as well as scope
 
 		std::vector<VkDescriptorSetLayoutBinding> _pushDescriptorLayoutBindings;
@@ -27,10 +27,10 @@ namespace val {
 		tinyobj::attrib_t _meshAttribs;
 
 		VkBuffer _vertexBuffer = NULL;
-		VkDeviceMemory _vertexBufferMem = NULL;
+		memoryAllocation _vertexBufferMem;
 
 		VkBuffer _indexBuffer = NULL;
-		VkDeviceMemory _indexBufferMem = NULL;
+		memoryAllocation _indexBufferMem;
 
 		val::VAL_PROC& _proc;
 	};
@@ -28,8 +28,11 @@ namespace val {
 		vkResetCommandBuffer(cmd, 0);
 	}
 
-	inline void BEGIN_COMMAND_BUFFER(VkCommandBuffer& cmd) 
+	inline void BEGIN_COMMAND_BUFFER(VAL_PROC& proc, VkCommandBuffer& cmd) 
 	{
+		// the writes of shader::update* are only queued, the writes to the sets of the current frame are applied
+		proc.flushDescriptorWrites();
+
 		thread_local static VkCommandBufferBeginInfo beginInfo;
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		beginInfo.pNext = VK_NULL_HANDLE;
@@ -70,8 +73,10 @@ namespace val {
 		//VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
 		// bind pipeline and respective descriptor sets
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.getVkPipeline(proc));
+		VkDescriptorSet descriptorSets[(uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT];
+		const uint32_t descriptorSetCount = proc.getDescriptorSetsToBind(pipeline, proc._currentFrame, descriptorSets);
 		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, proc._pipelineLayouts[pipelineIdx],
-			0, 1, &proc._descriptorSets[pipelineIdx][proc._currentFrame], 0, nullptr);
+			0, descriptorSetCount, descriptorSets, pipeline.defaultDynamicOffsets.size(), pipeline.defaultDynamicOffsets.data());
 	}
 
 	inline void setViewport(const VkViewport& viewport, VkCommandBuffer& commandBuffer) {
@@ -26,7 +26,8 @@ namespace val {
 
 	inline void RESET_COMMAND_BUFFER(VkCommandBuffer& cmd);
 
-	inline void BEGIN_COMMAND_BUFFER(VkCommandBuffer& cmd);
+	// flushes the queued descriptor writes of the proc, descriptor sets can't be updated once the command buffer has bound them
+	inline void BEGIN_COMMAND_BUFFER(VAL_PROC& proc, VkCommandBuffer& cmd);
 
 	inline void END_COMMAND_BUFFER(VkCommandBuffer& cmd);
 
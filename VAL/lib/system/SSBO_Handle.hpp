@@ -3,6 +3,8 @@
 
 #include <VAL/lib/system/system_utils.hpp>
 
+#include <VAL/lib/system/SSBO_arr_manager.hpp>
+
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
@@ -22,14 +24,26 @@ namespace val {
 
 		void updateFromTempStagingBuffer(VAL_PROC& proc, void* data);
 
-		//void resize(VAL_PROC& proc, size_t size);
+		// returns the mapped data of the SSBO at the current frame, the SSBO must be CPU_GPU
+		void* getData(VAL_PROC& proc);
+
+		void* getData(VAL_PROC& proc, const uint8_t frameIdx);
+
+		// resizes the SSBO without recreating the pipelines that use it, the contents are preserved up to the smaller of the two sizes.
+		// If the SSBO outgrows it's stride it is moved into a new buffer whose capacity grows geometrically.
+		// The descriptor sets of the current frame are rewritten immediately, so this must not be called while the commands of the frame are recorded.
+		// The other frames are rewritten once they become current (see VAL_PROC::nextFrame).
+		void resize(VAL_PROC& proc, const uint64_t size);
 
 		//void* getMappedData(VAL_PROC& pro);
 
+		// every frame of the SSBO is a range of the same buffer, which begins at getOffset(frameIdx)
 		VkBuffer getBuffer(VAL_PROC& proc);
 
 		std::vector<VkBuffer> getBuffers(VAL_PROC& proc);
 
+		VkDeviceSize getOffset(const uint8_t frameIdx) const;
+
 		VkMemoryPropertyFlags getMemoryPropertyFlags();
 
 		static inline VkDescriptorType getVkDescriptorType() { return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER; }
@@ -38,6 +52,10 @@ namespace val {
 		uint64_t _size = 0;
 		int _index = 0;
 
+		ssboArraySubset* _arrSubset = NULL;
+		VkDeviceSize _offset = 0u; // the offset of the first frame within the buffer of the subset
+		VkDeviceSize _stride = 0u; // the distance between two frames and the capacity of each frame, a multiple of minStorageBufferOffsetAlignment
+
 		VkBufferUsageFlags _additionalUsageFlags = 0;
 
 		// IF GPU ONLY: DOES NOT NEED TO BE MAPPED TO MEMORY
@@ -0,0 +1,97 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_SSBO_ARR_MANAGER_HPP
+#define VAL_SSBO_ARR_MANAGER_HPP
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <VAL/lib/system/system_utils.hpp>
+#include <VAL/lib/system/memoryAllocator.hpp>
+
+#include <vector>
+#include <list>
+
+namespace val {
+
+	class SSBO_Handle; // forward declaration
+
+	// holds every SSBO with the same buffer space and usage flags in one buffer
+	struct ssboArraySubset {
+		void create(VAL_PROC& proc, VkBufferUsageFlags additionalUsages, bufferSpace space, SSBO_Handle** ssboHandles, uint32_t ssboCount);
+		void destroy(VAL_PROC& proc);
+
+		// data is laid out in a 2d array packed into a fixed, 1d array like so:
+		// [ssboIndex][frameIndex]
+		// every frame of every SSBO begins at a multiple of minStorageBufferOffsetAlignment
+		VkDeviceSize _size = 0u; // in bytes
+		bufferSpace _space = GPU_ONLY;
+		VkBufferUsageFlags _usage = 0u;
+		memoryAllocation _vkMem;
+		VkBuffer _vkBuff = VK_NULL_HANDLE;
+		void* _dataMapped = NULL;
+		uint32_t _handleCount = 0u; // the number of SSBOs that are packed into the buffer
+
+		// the ranges of SSBOs that have been released from the subset or moved out of it by a resize
+		struct freeRange {
+			VkDeviceSize offset = 0u;
+			VkDeviceSize stride = 0u; // the range spans stride * frameCount bytes
+			uint32_t framesLeft = 0u; // the number of calls to nextFrame() until the frames in flight can no longer use the range
+		};
+		std::vector<freeRange> _freeRanges;
+	};
+
+	// an arena of SSBOs, with one buffer and one allocation for each combination of buffer space and usage flags
+	struct ssboArray {
+		void create(VAL_PROC& proc, SSBO_Handle** ssboHandles, uint32_t ssboCount);
+		void destroy(VAL_PROC& proc);
+
+		// packs SSBOs that are added after the array has been created into new subsets, the subsets that already exist are left untouched
+		void append(VAL_PROC& proc, SSBO_Handle** ssboHandles, uint32_t ssboCount);
+
+		// removes the SSBO from it's subset. The range of the SSBO is returned to the free ranges of the subset,
+		// once every SSBO of the subset has been released the buffer of the subset is retired by the VAL_PROC.
+		void release(VAL_PROC& proc, SSBO_Handle* ssboHandle);
+
+		// moves the SSBO into frames of at least newStride bytes and copies it's contents into them.
+		// An SSBO that shares it's subset with other SSBOs is moved into a retired free range that is large enough,
+		// or into a subset of it's own. Otherwise the old buffer of the subset is retired by the VAL_PROC.
+		// The frames that may be in flight are copied on the GPU, ordered after the work that was submitted before.
+		void resize(VAL_PROC& proc, SSBO_Handle* ssboHandle, const VkDeviceSize newStride);
+
+		// called by VAL_PROC::nextFrame(), counts down the retirement of the free ranges
+		void nextFrame();
+
+		// the SSBO handles point into this container, so it must not invalidate references when subsets are added or erased
+		std::list<ssboArraySubset> _subsets;
+
+	protected:
+		// removes a retired free range of at least minStride bytes per frame from a subset with the space and usage flags,
+		// returns NULL if there is none
+		ssboArraySubset* takeFreeRange(const bufferSpace space, const VkBufferUsageFlags usage, const VkDeviceSize minStride,
+			VkDeviceSize& offsetOut, VkDeviceSize& strideOut);
+
+		// returns the range of the SSBO to the free ranges of it's subset, or retires the subset if it was the last SSBO in it
+		void releaseRange(VAL_PROC& proc, ssboArraySubset* subset, const SSBO_Handle* ssboHandle);
+
+		int _nextIndex = 0; // the index of the next SSBO if there are no free indices
+		std::vector<int> _freeIndices; // the indices of released SSBOs
+	};
+}
+
+#endif //!VAL_SSBO_ARR_MANAGER_HPP
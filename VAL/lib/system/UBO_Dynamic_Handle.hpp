@@ -1,11 +1,60 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
 #ifndef VAL_UBO_DYNAMIC_HANDLE_HPP
-#define VAL_UBO_DYNAMIC_HANLDE_HPP
+#define VAL_UBO_DYNAMIC_HANDLE_HPP
 
 #include <VAL/lib/system/UBO_Handle.hpp>
 
 namespace val {
+	// A UBO that holds an array of elements, which are bound through a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptor.
+	// The descriptor is written once, and the element that a draw reads is selected with a dynamic offset when the descriptor set is bound.
+	// i.e. per object transforms:
+	//		val::UBO_Dynamic_Handle transforms(sizeof(glm::mat4), OBJECT_COUNT);
+	//		...
+	//		for (uint32_t i = 0; i < OBJECT_COUNT; ++i) {
+	//			const uint32_t offset = transforms.getDynamicOffset(i);
+	//			renderTarget.rebindDescriptorSet(proc, pipeline, &offset, 1u);
+	//			renderTarget.render(proc);
+	//		}
 	struct UBO_Dynamic_Handle : UBO_Handle {
+		// sizeOfElement is the size of the block that is declared in the shader, elements are padded to minUniformBufferOffsetAlignment
+		UBO_Dynamic_Handle(uint16_t sizeOfElement, uint32_t elementCount, bufferSpace space = CPU_GPU)
+			: UBO_Handle(sizeOfElement, elementCount, space, 0x0) {};
+		UBO_Dynamic_Handle(uint16_t sizeOfElement, uint32_t elementCount, bufferSpace space, VkBufferUsageFlags additionalUsageFlags)
+			: UBO_Handle(sizeOfElement, elementCount, space, additionalUsageFlags) {};
+
+	public:
+		// returns the mapped data of the element at the current frame
+		void* getElementData(VAL_PROC& proc, const uint32_t elementIdx);
+
+		void* getElementData(VAL_PROC& proc, const uint32_t elementIdx, const uint8_t frameIdx);
+
+		// copies sizeOfElement bytes of data into the element at the current frame
+		void updateElement(VAL_PROC& proc, const void* data, const uint32_t elementIdx);
+
+		void updateElement(VAL_PROC& proc, const void* data, const uint32_t elementIdx, const uint8_t frameIdx);
+
+		// the dynamic offset that selects the element, it is the same for every frame
+		inline uint32_t getDynamicOffset(const uint32_t elementIdx) const { return elementIdx * _stride; }
+
+		inline uint32_t getElementCount() const { return _elementCount; }
 
+		inline uint32_t getStride() const { return _stride; }
 	};
 }
 #endif // !VAL_UBO_DYNAMIC_HANDLE_HPP
@@ -30,6 +30,11 @@ namespace val {
 		UBO_Handle(uint16_t sizeOfUBO, bufferSpace space = CPU_GPU) : _size(sizeOfUBO), _space(space) {};
 		UBO_Handle(uint16_t sizeOfUBO, bufferSpace space, VkBufferUsageFlags additionalUsageFlags) : _size(sizeOfUBO), _space(space), _additionalUsageFlags(additionalUsageFlags){};
 
+	protected:
+		// used by UBO_Dynamic_Handle
+		UBO_Handle(uint16_t sizeOfElement, uint32_t elementCount, bufferSpace space, VkBufferUsageFlags additionalUsageFlags)
+			: _size(sizeOfElement), _elementCount(elementCount), _dynamic(true), _additionalUsageFlags(additionalUsageFlags), _space(space) {};
+
 	public:
 		void* getData(VAL_PROC& proc);
 
@@ -43,16 +48,23 @@ namespace val {
 
 		uboArraySubset* getUBOarraySubset(VAL_PROC& proc);
 
+		// the offset of the UBO within it's buffer at the specified frame, this is the offset that descriptors of the frame point to
+		uint32_t getOffset(const uint8_t frameIdx);
+
 
 		//void* getMappedData(VAL_PROC& pro);
 
 		VkMemoryPropertyFlags getMemoryPropertyFlags();
 
-		static inline VkDescriptorType getVkDescriptorType() { return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; }
+		inline VkDescriptorType getVkDescriptorType() const { return _dynamic ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; }
 
 	public:
 		const uint32_t _size = 0u; // Vulkan spec states that every device must support at least 16KB as the max size in bytes of a UBO buffer, some go up to 64 KB in size
-		uint32_t _offset = 0u;
+		uint32_t _offset = 0u; // relative to the beginning of the frame, aligned to minUniformBufferOffsetAlignment
+		// the size of an element rounded up to minUniformBufferOffsetAlignment, set when the UBO is packed into it's uboArraySubset
+		uint32_t _stride = 0u;
+		const uint32_t _elementCount = 1u;
+		const bool _dynamic = false;
 
 		uboArraySubset* _arrSubset = NULL;
 
@@ -23,6 +23,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 #include <VAL/lib/system/system_utils.hpp>
 
+#include <list>
 
 namespace val {
 
@@ -36,14 +37,24 @@ namespace val {
 		size_t _sizePerFrame = 0; // in bytes
 		// data is laid out in a 2d array packed into a fixed, 1d array like so:
 		// [frameIndex][uboIndex]
-		VkDeviceMemory _vkMem;
-		VkBuffer _vkBuff;
-		void* _dataMapped;
+		// each UBO, and the beginning of each frame, is aligned to minUniformBufferOffsetAlignment
+		memoryAllocation _vkMem;
+		VkBuffer _vkBuff = VK_NULL_HANDLE;
+		void* _dataMapped = NULL;
+		uint32_t _handleCount = 0u; // the number of UBOs that are packed into the buffer
 	};
 
 	struct uboArray {
 		void create(VAL_PROC& proc, UBO_Handle** uboHandles, uint32_t uboCount);
 		void destroy(VAL_PROC& proc);
+
+		// packs UBOs that are added after the array has been created into new subsets, one for each combination of buffer space and usage flags
+		void append(VAL_PROC& proc, UBO_Handle** uboHandles, uint32_t uboCount);
+
+		// removes the UBO from it's subset. The range of the UBO stays unused until every UBO of the subset has been released,
+		// then the buffer of the subset is retired by the VAL_PROC.
+		void release(VAL_PROC& proc, UBO_Handle* uboHandle);
+
 		/*************************************/
 		/* GPU-only memory                   */
 		uboArraySubset localReadOnly;
@@ -69,6 +80,10 @@ namespace val {
 		// VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (yes, it's technically possible to have a UBO that dual purposes as an SSBO, but this is a bad design practice.)
 		// VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
 		uboArraySubset globalOther;
+
+		/*************************************/
+		// the subsets of UBOs that were appended, the UBO handles point into this container so it must not invalidate references
+		std::list<uboArraySubset> _appendedSubsets;
 	};
 }
 
@@ -0,0 +1,133 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_ASYNC_UPLOADER_HPP
+#define VAL_ASYNC_UPLOADER_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <VAL/lib/system/memoryAllocator.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace val {
+	class VAL_PROC; // forward declaration
+
+	// the value that the timeline semaphore of the asyncUploader reaches once an upload has completed.
+	// A token of 0 refers to no upload, and is always complete.
+	typedef uint64_t uploadToken;
+
+	// Records uploads onto the transfer queue and submits them without blocking the CPU.
+	// If the transfer queue belongs to a different queue family than the graphics queue, the ownership of the
+	// resources is released by the transfer queue and acquired by the graphics queue in acquire().
+	// Ownership transfers only preserve the uploaded range, the rest of the resource should be treated as undefined.
+	class asyncUploader {
+	public:
+		asyncUploader() = default;
+		asyncUploader(const asyncUploader& other) = delete;
+		~asyncUploader() {
+			destroy();
+		}
+	public:
+		void create(VAL_PROC& proc);
+
+		// waits for all uploads to complete and destroys the uploader
+		void destroy();
+
+		inline bool isCreated() const { return _timeline != VK_NULL_HANDLE; }
+
+		uploadToken uploadBuffer(const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize dstOffset = 0u);
+
+		// uploads tightly packed texels to the first mip level of the image. The image must be in VK_IMAGE_LAYOUT_UNDEFINED,
+		// and is transitioned to finalLayout once it has been acquired.
+		uploadToken uploadImage(const void* data, const VkDeviceSize size, VkImage dstImage, const uint32_t width, const uint32_t height,
+			const VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, const VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+
+		// makes everything that is submitted to the graphics queue after this call wait for the upload,
+		// and acquires the ownership of the resources that were uploaded up to and including the token.
+		void acquire(const uploadToken token);
+
+		bool isComplete(const uploadToken token);
+
+		// blocks until the upload has completed
+		void wait(const uploadToken token);
+
+		// returns the token of the most recent upload
+		uploadToken getLastToken() const;
+
+	protected:
+		struct submission {
+			uint64_t value = 0u; // the value of the timeline semaphore that signals the completion of the submission
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkBuffer stagingBuffer = VK_NULL_HANDLE;
+			memoryAllocation stagingMemory;
+		};
+
+		// a resource that has been released by the transfer queue, but not yet acquired by the graphics queue
+		struct pendingAcquire {
+			uploadToken token = 0u;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0u;
+			VkDeviceSize size = 0u;
+			VkImage image = VK_NULL_HANDLE;
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkImageAspectFlags aspect = 0u;
+		};
+
+		inline bool requiresOwnershipTransfer() const { return _transferFamily != _graphicsFamily; }
+
+		VkCommandBuffer beginCommandBuffer(VkCommandPool pool);
+
+		void submit(VkQueue queue, VkCommandBuffer commandBuffer, VkSemaphore signalSemaphore, const uint64_t signalValue,
+			VkSemaphore waitSemaphore = VK_NULL_HANDLE, const uint64_t waitValue = 0u);
+
+		// copies the data into a new staging buffer
+		void createStagingBuffer(const void* data, const VkDeviceSize size, submission& submissionOut);
+
+		// frees the command buffers and staging buffers of the submissions that have completed
+		void collect();
+
+	protected:
+		VAL_PROC* _proc = NULL;
+
+		// command buffers that are submitted to the transfer queue must be allocated from a pool of it's family
+		VkCommandPool _transferCommandPool = VK_NULL_HANDLE;
+
+		uint32_t _transferFamily = 0u;
+		uint32_t _graphicsFamily = 0u;
+
+		// signalled by the transfer queue, one value for every upload
+		VkSemaphore _timeline = VK_NULL_HANDLE;
+		uint64_t _timelineValue = 0u;
+
+		// signalled by the graphics queue, one value for every acquire
+		VkSemaphore _acquireTimeline = VK_NULL_HANDLE;
+		uint64_t _acquireTimelineValue = 0u;
+
+		uploadToken _lastAcquiredToken = 0u;
+
+		std::vector<submission> _uploadsInFlight;
+		std::vector<submission> _acquiresInFlight;
+		std::vector<pendingAcquire> _pendingAcquires;
+	};
+}
+
+#endif // !VAL_ASYNC_UPLOADER_HPP
@@ -0,0 +1,134 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_BINDLESS_SET_HPP
+#define VAL_BINDLESS_SET_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <VAL/lib/system/descriptorWriteBatch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// the sizes of the arrays of the bindless set, they are clamped to the update after bind limits of the device
+#ifndef VAL_BINDLESS_MAX_SAMPLED_IMAGES
+#define VAL_BINDLESS_MAX_SAMPLED_IMAGES 16384u
+#endif // !VAL_BINDLESS_MAX_SAMPLED_IMAGES
+
+#ifndef VAL_BINDLESS_MAX_SAMPLERS
+#define VAL_BINDLESS_MAX_SAMPLERS 256u
+#endif // !VAL_BINDLESS_MAX_SAMPLERS
+
+#ifndef VAL_BINDLESS_MAX_STORAGE_BUFFERS
+#define VAL_BINDLESS_MAX_STORAGE_BUFFERS 4096u
+#endif // !VAL_BINDLESS_MAX_STORAGE_BUFFERS
+
+#define VAL_BINDLESS_INVALID_INDEX UINT32_MAX
+
+namespace val {
+
+	// the bindings of the bindless set, i.e. in GLSL with the set number of pipelineCreateInfo::bindlessSetNo:
+	//		layout(set = 1, binding = 0) uniform texture2D textures[];
+	//		layout(set = 1, binding = 1) uniform sampler samplers[];
+	//		layout(set = 1, binding = 2) buffer Data { ... } buffers[];
+	enum class BINDLESS_BINDING : uint32_t {
+		SAMPLED_IMAGES = 0,
+		SAMPLERS = 1,
+		STORAGE_BUFFERS = 2,
+		BINDING_COUNT = 3
+	};
+
+	// One global descriptor set with large UPDATE_AFTER_BIND and PARTIALLY_BOUND arrays of sampled images, samplers and storage buffers.
+	// Every resource that is added gets an index that stays valid until it's removed, shaders index the arrays with it,
+	// so changing the resources of a draw only means changing the index that is passed to it (i.e. with a push constant).
+	// The writes are queued in a descriptorWriteBatch, because the set is update after bind it's never reallocated per frame.
+	class bindlessSet {
+	public:
+		bindlessSet() = default;
+		bindlessSet(const bindlessSet& other) = delete;
+		~bindlessSet() {
+			destroy();
+		}
+	public:
+		// removed indices are reused after retireFrames calls to nextFrame(), once no frame in flight can access them anymore
+		void create(VkPhysicalDevice physicalDevice, VkDevice device, descriptorWriteBatch& writes, const uint32_t retireFrames);
+
+		void destroy();
+
+		// the image must have been created with VK_IMAGE_USAGE_SAMPLED_BIT
+		uint32_t addSampledImage(VkImageView imageView, const VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		uint32_t addSampler(VkSampler sampler);
+
+		uint32_t addStorageBuffer(VkBuffer buffer, const VkDeviceSize offset = 0u, const VkDeviceSize range = VK_WHOLE_SIZE);
+
+		// replaces the descriptor at the index. The index must not be used by any frame in flight, rewriting a descriptor
+		// that a pending command buffer uses is undefined, even with update after bind. Add a new index and remove the old one instead.
+		void updateSampledImage(const uint32_t index, VkImageView imageView, const VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		// the same applies to storage buffers
+		void updateStorageBuffer(const uint32_t index, VkBuffer buffer, const VkDeviceSize offset = 0u, const VkDeviceSize range = VK_WHOLE_SIZE);
+
+		// the index can be returned by an add function again once the frames in flight can no longer access it.
+		// A write to the index that hasn't been flushed yet is dropped, so the resource can be destroyed right after this call.
+		void remove(const BINDLESS_BINDING binding, const uint32_t index);
+
+		// called by VAL_PROC::nextFrame(), releases the removed indices whose frames have completed
+		void nextFrame();
+
+		void bind(VkCommandBuffer cmdBuffer, const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const uint32_t setNo) const;
+
+		inline VkDescriptorSetLayout getVkDescriptorSetLayout() const { return _layout; }
+
+		inline VkDescriptorSet getVkDescriptorSet() const { return _set; }
+
+		inline uint32_t getCapacity(const BINDLESS_BINDING binding) const { return _arrays[(uint32_t)binding].capacity; }
+
+		inline bool isCreated() const { return _set != VK_NULL_HANDLE; }
+
+	protected:
+		struct retiredIndex {
+			uint32_t index = 0u;
+			uint32_t framesLeft = 0u;
+		};
+
+		struct indexArray {
+			uint32_t capacity = 0u;
+			uint32_t nextIndex = 0u; // the indices from here up to the capacity have never been used
+			std::vector<uint32_t> freeIndices;
+			std::vector<retiredIndex> retiredIndices;
+		};
+
+		// returns VAL_BINDLESS_INVALID_INDEX if the array is full
+		uint32_t acquireIndex(const BINDLESS_BINDING binding);
+
+	protected:
+		VkDevice _device = VK_NULL_HANDLE;
+		VkDescriptorPool _pool = VK_NULL_HANDLE;
+		VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+		VkDescriptorSet _set = VK_NULL_HANDLE;
+		descriptorWriteBatch* _writes = NULL;
+		uint32_t _retireFrames = 0u;
+		indexArray _arrays[(uint32_t)BINDLESS_BINDING::BINDING_COUNT];
+	};
+}
+
+#endif // !VAL_BINDLESS_SET_HPP
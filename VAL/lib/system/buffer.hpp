@@ -12,9 +12,9 @@ namespace val
 		buffer(VAL_PROC& proc) : _proc(proc) {}
 
 		// creates the buffer from the input values.
-		buffer(VAL_PROC& proc, const uint32_t& size, const bufferSpace& space, const VkBufferUsageFlags bufferUsage, uint16_t frameCount = 1u)
+		buffer(VAL_PROC& proc, const uint32_t& size, const bufferSpace& space, const VkBufferUsageFlags bufferUsage, uint16_t frameCount = 1u, const bool packFrames = false)
 			: _proc(proc) {
-			create(proc, size, space, bufferUsage, frameCount);
+			create(proc, size, space, bufferUsage, frameCount, packFrames);
 		}
 		~buffer() {
 			destroy();
@@ -28,7 +28,10 @@ namespace val
 		}
 
 	public:
-		void create(VAL_PROC& proc, const uint32_t& size, const bufferSpace& usage, const VkBufferUsageFlags bufferUsage, uint16_t frameCount = 1u);
+		// if packFrames is true, all frames share one VkBuffer and one allocation, which is mapped once.
+		// The frame begins at getOffset(frameIdx) within the buffer, and the offsets are aligned to the requirements of the bufferUsage,
+		// so that the frame can be selected with a dynamic offset instead of a descriptor set per frame.
+		void create(VAL_PROC& proc, const uint32_t& size, const bufferSpace& usage, const VkBufferUsageFlags bufferUsage, uint16_t frameCount = 1u, const bool packFrames = false);
 
 		void overwriteFromStagingBuffer(void* data, uint64_t dataSize, uint16_t frameIdx, VkDeviceSize srcOffset = 0U, VkDeviceSize dstOffset = 0U);
 
@@ -56,10 +59,22 @@ namespace val
 
 		const uint32_t& size() const;
 
+		// if the frames are packed, every frame returns the same VkBuffer and the frame must be selected with getOffset()
 		VkBuffer& getVkBuffer(const uint8_t frameIdx = 0);
 
+		// the offset of the frame within it's VkBuffer, which is always 0 if the frames are not packed
+		VkDeviceSize getOffset(const uint8_t frameIdx = 0u) const;
+
+		// the distance between the beginnings of two consecutive frames of a packed buffer
+		VkDeviceSize getFrameStride() const;
+
+		bool isPacked() const;
+
 		const VkDeviceMemory& getDeviceMemory(const uint8_t frameIdx);
 
+		// the range of device memory that the buffer of the frame is bound to, every frame of a packed buffer shares the same allocation
+		const memoryAllocation& getMemoryAllocation(const uint8_t frameIdx);
+
 		void* getDataMapped(const uint8_t frameIdx = 0u);
 
 		const VkBufferUsageFlags& getUsageFlags() const;
@@ -69,14 +84,24 @@ namespace val
 	protected:
 		void copy(const buffer& other);
 
+		// returns the size of a frame rounded up to the offset alignment that the usage flags require
+		VkDeviceSize calculateFrameStride(const uint32_t size) const;
+
+		inline uint8_t allocationIdx(const uint8_t frameIdx) const { return _packed ? 0u : frameIdx; }
+
 	protected:
 		VAL_PROC& _proc;  // Store a reference
 		uint32_t _size = 0u;
 		bufferSpace _space{};
 		VkBufferUsageFlags _usage = 0;
-		// each vector has a size equivalent to the frame count that it was initialized with
-		std::vector<VkBuffer> _buffers; // it would be more efficient to pack this data into just 1 buffer. i.e. VkBuffer* (which includes the data for both frames that can be accessed with an offset)
-		std::vector<VkDeviceMemory> _memory;
+		uint32_t _frameCount = 0u;
+		bool _packed = false;
+		VkDeviceSize _frameStride = 0u;
+		// each vector has a size equivalent to the frame count that it was initialized with.
+		// If the frames are packed, every element of _buffers holds the same handle and _memory only has 1 element.
+		std::vector<VkBuffer> _buffers;
+		std::vector<VkDeviceSize> _offsets;
+		std::vector<memoryAllocation> _memory;
 		std::vector<void*> _dataMapped;
 	};
 }
@@ -17,7 +17,8 @@ namespace val {
 		void destroy(VAL_PROC& proc);
 	public:
 		VkImage depthImage;
-		VkDeviceMemory depthImageMemory;
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		memoryAllocation depthImageMemory;
 		std::vector<VkImageView> imgViews;
 	};
 }
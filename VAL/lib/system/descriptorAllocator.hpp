@@ -0,0 +1,101 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_DESCRIPTOR_ALLOCATOR_HPP
+#define VAL_DESCRIPTOR_ALLOCATOR_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <cstdint>
+#include <vector>
+
+// the number of sets that the first pool of a descriptor allocator can hold, every new pool holds 1.5x more than the previous one
+#ifndef VAL_DESCRIPTOR_ALLOCATOR_SETS_PER_POOL
+#define VAL_DESCRIPTOR_ALLOCATOR_SETS_PER_POOL 64u
+#endif // !VAL_DESCRIPTOR_ALLOCATOR_SETS_PER_POOL
+
+#ifndef VAL_DESCRIPTOR_ALLOCATOR_MAX_SETS_PER_POOL
+#define VAL_DESCRIPTOR_ALLOCATOR_MAX_SETS_PER_POOL 4096u
+#endif // !VAL_DESCRIPTOR_ALLOCATOR_MAX_SETS_PER_POOL
+
+namespace val {
+
+	// Allocates descriptor sets of any layout from a list of shared descriptor pools. When a pool is exhausted
+	// (VK_ERROR_OUT_OF_POOL_MEMORY or VK_ERROR_FRAGMENTED_POOL) it's set aside and a new, larger pool is created.
+	// The pools are sized by the number of descriptors of each type per set, and are made large enough for the sets that
+	// triggered their creation. reset() returns every set to the pools at once, which makes allocators that are reset
+	// every frame an almost free way to get transient sets. The allocator is not thread safe.
+	class descriptorAllocator {
+	public:
+		// the average number of descriptors of the type in one set
+		struct poolSizeRatio {
+			VkDescriptorType type;
+			float ratio;
+		};
+
+		descriptorAllocator() = default;
+		descriptorAllocator(const descriptorAllocator& other) = delete;
+		descriptorAllocator(descriptorAllocator&& other) noexcept;
+		~descriptorAllocator() {
+			destroy();
+		}
+	public:
+		// if freeable is true, the sets can be returned individually with free(), otherwise only with reset()
+		void create(VkDevice device, const bool freeable = false, const uint32_t setsPerPool = VAL_DESCRIPTOR_ALLOCATOR_SETS_PER_POOL,
+			const std::vector<poolSizeRatio>& ratios = getDefaultRatios());
+
+		void destroy();
+
+		inline bool isCreated() const { return _device != VK_NULL_HANDLE; }
+
+		// allocates a set for every layout, and returns the pool they were allocated from.
+		// requiredSizes are the descriptors that the sets need in total, a new pool is made at least large enough to hold them.
+		VkDescriptorPool allocate(const VkDescriptorSetLayout* layouts, const uint32_t setCount, VkDescriptorSet* setsOut,
+			const std::vector<VkDescriptorPoolSize>& requiredSizes = {}, const void* pNext = NULL);
+
+		VkDescriptorSet allocate(VkDescriptorSetLayout layout, const std::vector<VkDescriptorPoolSize>& requiredSizes = {});
+
+		// returns the sets to the pool that they were allocated from, the allocator must have been created as freeable
+		void free(VkDescriptorPool pool, const VkDescriptorSet* sets, const uint32_t setCount);
+
+		// returns every set to the pools with vkResetDescriptorPool, the sets must not be in use by the GPU anymore
+		void reset();
+
+		inline size_t getPoolCount() const { return _readyPools.size() + _fullPools.size(); }
+
+		static const std::vector<poolSizeRatio>& getDefaultRatios();
+
+	protected:
+		// returns a pool that may still have space, a new one is created if there is none
+		VkDescriptorPool getPool(const std::vector<VkDescriptorPoolSize>& requiredSizes);
+
+		VkDescriptorPool createPool(const uint32_t setCount, const std::vector<VkDescriptorPoolSize>& requiredSizes);
+
+	protected:
+		VkDevice _device = VK_NULL_HANDLE;
+		VkDescriptorPoolCreateFlags _flags = 0u;
+		uint32_t _setsPerPool = 0u;
+		std::vector<poolSizeRatio> _ratios;
+		std::vector<VkDescriptorPool> _readyPools; // pools that may still have space, the last one is allocated from
+		std::vector<VkDescriptorPool> _fullPools;
+	};
+}
+
+#endif // !VAL_DESCRIPTOR_ALLOCATOR_HPP
@@ -5,25 +5,68 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <cstdint>
 
 namespace val {
 
+	// how often the descriptors of a binding are changed. The bindings of every update rate are in a set of their own, at the same
+	// set number in every pipeline (see getUpdateRateSetNo): PER_FRAME bindings are in set 0, the sets of PER_PASS, PER_MATERIAL and
+	// PER_DRAW follow it in that order. The sets of the rates that a pipeline has no bindings of are empty if a higher set has bindings.
+	// The static set directly follows the highest of them (see pipelineCreateInfo::getSetNo). Rebinding a set leaves the sets below it
+	// bound, so the sets that change most often have the highest set numbers. Bindings that aren't PER_FRAME must have binding indices
+	// that are unique within the pipeline. i.e. with bindings of every rate:
+	//		layout(set = 0, binding = 0) uniform Camera { ... };		// PER_FRAME
+	//		layout(set = 1, binding = 2) uniform Lights { ... };		// PER_PASS
+	//		layout(set = 2, binding = 3) uniform Material { ... };		// PER_MATERIAL
+	//		layout(set = 3, binding = 4) uniform Transform { ... };	// PER_DRAW
+	//		layout(set = 4, binding = 1) uniform texture2D albedo;		// STATIC, in set 1 if the pipeline only had PER_FRAME bindings besides it
+	enum class DESCRIPTOR_UPDATE_RATE : uint8_t {
+		// the binding has a descriptor in the set of every frame in flight, so that it can be updated while earlier frames are rendering
+		PER_FRAME,
+		// the binding is in the static set of the pipeline, which has one copy that is shared by every frame in flight. Writing it
+		// doesn't wait for the frames in flight, the set is replaced by a new copy with the write (see VAL_PROC::replaceStaticDescriptorSet).
+		// A UBO or SSBO of a static binding references the region of one frame, shader::updateUBO and updateSSBO write the region of frame 0.
+		STATIC,
+		// the sets of these rates have one copy for every frame in flight like set 0. Other sets of the same layout, i.e. one for every
+		// material, can be bound in place of them with renderTarget::bindDescriptorSet (see VAL_PROC::getDescriptorSetLayout)
+		PER_PASS,
+		PER_MATERIAL,
+		PER_DRAW,
+		RATE_COUNT
+	};
+
+	// the number of sets that the update rates other than STATIC have at fixed set numbers, the static set, the push descriptors
+	// and the bindless set follow them (see pipelineCreateInfo)
+	constexpr uint32_t UPDATE_RATE_SET_COUNT = 4u;
+
+	// returns the set number of the bindings of the update rate, which is the same in every pipeline.
+	// The static set has no fixed set number, UINT32_MAX is returned for it
+	constexpr uint32_t getUpdateRateSetNo(const DESCRIPTOR_UPDATE_RATE updateRate) {
+		if (updateRate == DESCRIPTOR_UPDATE_RATE::STATIC) {
+			return UINT32_MAX;
+		}
+		return (updateRate == DESCRIPTOR_UPDATE_RATE::PER_FRAME) ? 0u : (uint32_t)updateRate - 1u;
+	}
+
 	template <typename T> class descriptorBinding
 	{
 	public:
 		descriptorBinding() = default;
-		descriptorBinding(T val, uint32_t bindingIndex) {
+		descriptorBinding(T val, uint32_t bindingIndex, DESCRIPTOR_UPDATE_RATE updateRate = DESCRIPTOR_UPDATE_RATE::PER_FRAME) {
 			this->values.resize(1);
 			this->values[0] = val;
 			this->bindingIndex = bindingIndex;
+			this->updateRate = updateRate;
 		}
-		descriptorBinding(std::vector<T> values, uint32_t bindingIndex) {
+		descriptorBinding(std::vector<T> values, uint32_t bindingIndex, DESCRIPTOR_UPDATE_RATE updateRate = DESCRIPTOR_UPDATE_RATE::PER_FRAME) {
 			this->values = values;
 			this->bindingIndex = bindingIndex;
+			this->updateRate = updateRate;
 		}
 	public:
 		std::vector<T> values;
 		uint32_t bindingIndex = 0;
+		DESCRIPTOR_UPDATE_RATE updateRate = DESCRIPTOR_UPDATE_RATE::PER_FRAME;
 	};
 }
 
@@ -0,0 +1,175 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef VAL_DESCRIPTOR_BUFFER_ARENA_HPP
+#define VAL_DESCRIPTOR_BUFFER_ARENA_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <VAL/lib/system/memoryAllocator.hpp>
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+// the number of bytes of the descriptor buffer that hold the descriptor sets of the pipelines, which live until their pipeline is removed
+#ifndef VAL_DESCRIPTOR_BUFFER_PERSISTENT_SIZE
+#define VAL_DESCRIPTOR_BUFFER_PERSISTENT_SIZE (VkDeviceSize(4u) * 1024u * 1024u)
+#endif // !VAL_DESCRIPTOR_BUFFER_PERSISTENT_SIZE
+
+// the number of bytes of the descriptor buffer that is reserved for the transient sets of each frame
+#ifndef VAL_DESCRIPTOR_BUFFER_FRAME_SIZE
+#define VAL_DESCRIPTOR_BUFFER_FRAME_SIZE (VkDeviceSize(1u) * 1024u * 1024u)
+#endif // !VAL_DESCRIPTOR_BUFFER_FRAME_SIZE
+
+namespace val {
+	class VAL_PROC; // forward declaration
+
+	// One persistently mapped host visible buffer that descriptors are written into with vkGetDescriptorEXT (VK_EXT_descriptor_buffer).
+	// A descriptor set is a range of the buffer that is bound by it's offset, so there are no pools to allocate from and no driver side updates.
+	// The buffer holds a persistent region, that the sets of the pipelines are allocated from, followed by one region per frame
+	// for transient sets that are only valid for the frame they're allocated in.
+	// i.e. swapping the texture of every draw of a pipeline with useDescriptorBuffer:
+	//		const VkDeviceSize offset = proc.allocateTransientDescriptorBufferSet(pipeline);
+	//		proc._descriptorBuffer.writeImage(proc._descriptorSetLayouts[pipeline.descriptorsIdx], offset, binding, 0u, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, imageInfo);
+	//		target.setDescriptorBufferOffset(proc, pipeline, offset);
+	class descriptorBufferArena {
+	public:
+		descriptorBufferArena() = default;
+		descriptorBufferArena(const descriptorBufferArena& other) = delete;
+		~descriptorBufferArena() {
+			destroy();
+		}
+	public:
+		// the device must have the descriptorBuffer and bufferDeviceAddress features enabled
+		void create(VAL_PROC& proc, const uint8_t frameCount, const VkDeviceSize persistentSize = VAL_DESCRIPTOR_BUFFER_PERSISTENT_SIZE,
+			const VkDeviceSize frameSize = VAL_DESCRIPTOR_BUFFER_FRAME_SIZE);
+
+		void destroy();
+
+		// returns the offset of a range of the persistent region that is large enough for a set of the layout,
+		// the layout must have been created with VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+		VkDeviceSize allocate(VkDescriptorSetLayout layout);
+
+		// returns the range of the set to the persistent region, the GPU must not access it anymore
+		void free(const VkDeviceSize setOffset);
+
+		// returns the offset of a set in the region of the current frame, which is initialized with the descriptors of the set at the srcSetOffset.
+		// It's reused once nextFrame() comes around to the frame again.
+		VkDeviceSize allocateTransient(VkDescriptorSetLayout layout, const VkDeviceSize srcSetOffset);
+
+		// called by VAL_PROC::nextFrame(), the transient sets of the frame that comes around again can't be in use anymore
+		void nextFrame();
+
+		// the range of the buffer info must not be VK_WHOLE_SIZE, as the descriptor is made from the address of the buffer
+		void writeBuffer(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+			const VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo);
+
+		void writeImage(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+			const VkDescriptorType type, const VkDescriptorImageInfo& imageInfo);
+
+		// writes every descriptor of the VkWriteDescriptorSet into the set at the setOffset, the dstSet of the write is ignored
+		void write(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const VkWriteDescriptorSet& write);
+
+		// writeBuffer and writeImage write the mapped memory immediately, so they may only write sets that the GPU isn't using,
+		// i.e. the transient sets of the current frame. The writes to a set of the frame in flight are queued instead, and applied
+		// by flush(frameIdx) once the frame's fence has been waited on (see VAL_PROC::flushDescriptorWrites)
+		void queueBuffer(const uint8_t frameIdx, VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+			const VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo);
+
+		void queueImage(const uint8_t frameIdx, VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+			const VkDescriptorType type, const VkDescriptorImageInfo& imageInfo);
+
+		// applies the writes that have been queued for the frame in the order they were queued
+		void flush(const uint8_t frameIdx);
+
+		// drops the queued writes into the set, i.e. before it's freed
+		void discard(const VkDeviceSize setOffset);
+
+		// binds the buffer to the command buffer, which has to be done before the offsets of sets are set
+		void bind(VkCommandBuffer cmdBuffer) const;
+
+		// binds the set at the setOffset to set number 0 of the pipeline layout
+		void setOffset(VkCommandBuffer cmdBuffer, const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const VkDeviceSize setOffset) const;
+
+		// the size of a set of the layout, rounded up to descriptorBufferOffsetAlignment
+		VkDeviceSize getSetSize(VkDescriptorSetLayout layout);
+
+		inline VkBuffer getVkBuffer() const { return _buffer; }
+
+		inline bool isCreated() const { return _proc != NULL; }
+
+	protected:
+		struct pendingWrite {
+			VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+			VkDeviceSize setOffset = 0u;
+			uint32_t binding = 0u;
+			uint32_t arrayElement = 0u;
+			VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+			bool isImage = false;
+			VkDescriptorBufferInfo bufferInfo{};
+			VkDescriptorImageInfo imageInfo{};
+		};
+
+		VkDeviceSize getBindingOffset(VkDescriptorSetLayout layout, const uint32_t binding);
+
+		size_t getDescriptorSize(const VkDescriptorType type) const;
+
+		// returns the mapped pointer to the descriptor, arrays are tightly packed within their binding
+		char* getDescriptorPtr(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+			const VkDescriptorType type);
+
+	protected:
+		VAL_PROC* _proc = NULL;
+		VkBuffer _buffer = VK_NULL_HANDLE;
+		memoryAllocation _memory;
+		VkDeviceAddress _address = 0u;
+
+		VkPhysicalDeviceDescriptorBufferPropertiesEXT _properties{};
+
+		VkDeviceSize _persistentSize = 0u;
+		// free ranges of the persistent region by offset, adjacent ranges are merged when a set is freed
+		std::map<VkDeviceSize, VkDeviceSize> _freeRanges;
+		// the size of every set that has been allocated from the persistent region, by offset
+		std::unordered_map<VkDeviceSize, VkDeviceSize> _allocatedSets;
+
+		VkDeviceSize _frameSize = 0u;
+		uint8_t _frameCount = 0u;
+		uint8_t _frameIdx = 0u;
+		VkDeviceSize _frameHead = 0u;
+
+		// the writes that wait for their frame in flight to be current, indexed by the frame
+		std::vector<std::vector<pendingWrite>> _pendingWrites;
+
+		std::unordered_map<VkDescriptorSetLayout, VkDeviceSize> _setSizes;
+		std::map<std::pair<VkDescriptorSetLayout, uint32_t>, VkDeviceSize> _bindingOffsets;
+
+		// VK_EXT_descriptor_buffer isn't core, it's functions are loaded by create()
+		PFN_vkGetDescriptorSetLayoutSizeEXT _vkGetDescriptorSetLayoutSizeEXT = NULL;
+		PFN_vkGetDescriptorSetLayoutBindingOffsetEXT _vkGetDescriptorSetLayoutBindingOffsetEXT = NULL;
+		PFN_vkGetDescriptorEXT _vkGetDescriptorEXT = NULL;
+		PFN_vkCmdBindDescriptorBuffersEXT _vkCmdBindDescriptorBuffersEXT = NULL;
+		PFN_vkCmdSetDescriptorBufferOffsetsEXT _vkCmdSetDescriptorBufferOffsetsEXT = NULL;
+	};
+}
+
+#endif // !VAL_DESCRIPTOR_BUFFER_ARENA_HPP
@@ -0,0 +1,93 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_DESCRIPTOR_UPDATE_TEMPLATE_HPP
+#define VAL_DESCRIPTOR_UPDATE_TEMPLATE_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <cstdint>
+#include <vector>
+
+namespace val {
+
+	// Wraps a VkDescriptorUpdateTemplate that writes every binding of a descriptor set layout from one block of packed data.
+	// The data holds one VkDescriptorBufferInfo, VkDescriptorImageInfo or VkBufferView for every descriptor,
+	// in the order of the binding indices and then of the array elements, i.e. for bindings { 0: UBO, 1: sampler[2] }:
+	//		struct { VkDescriptorBufferInfo ubo; VkDescriptorImageInfo samplers[2]; };
+	// getOffset(), writeBuffer() and writeImage() can be used instead of declaring a matching struct.
+	class descriptorUpdateTemplate {
+	public:
+		descriptorUpdateTemplate() = default;
+		descriptorUpdateTemplate(const descriptorUpdateTemplate& other) = delete;
+		descriptorUpdateTemplate(descriptorUpdateTemplate&& other) noexcept;
+		~descriptorUpdateTemplate() {
+			destroy();
+		}
+	public:
+		// creates a template for vkUpdateDescriptorSetWithTemplate, the bindings must be the ones the setLayout was created with
+		void create(VkDevice device, VkDescriptorSetLayout setLayout, const VkDescriptorSetLayoutBinding* bindings, const uint32_t bindingCount);
+
+		// creates a template for vkCmdPushDescriptorSetWithTemplateKHR, which pushes to the set of the pipelineLayout
+		void createForPushDescriptors(VkDevice device, const VkDescriptorSetLayoutBinding* bindings, const uint32_t bindingCount,
+			const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const uint32_t set);
+
+		void destroy();
+
+		// returns the size of the packed data in bytes
+		inline size_t getDataSize() const { return _dataSize; }
+
+		// returns the offset of the descriptor in the packed data, or SIZE_MAX if the template has no such descriptor
+		size_t getOffset(const uint32_t binding, const uint32_t arrayElement = 0u) const;
+
+		// copies the info into the packed data at the offset of the descriptor
+		void writeBuffer(void* data, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorBufferInfo& bufferInfo) const;
+
+		void writeImage(void* data, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorImageInfo& imageInfo) const;
+
+		inline VkDescriptorUpdateTemplate getVkDescriptorUpdateTemplate() const { return _template; }
+
+		inline bool isCreated() const { return _template != VK_NULL_HANDLE; }
+
+		struct templateEntry {
+			uint32_t binding = 0u;
+			uint32_t descriptorCount = 0u;
+			size_t offset = 0u;
+			size_t stride = 0u;
+		};
+
+		// returns the bindings that the template writes, every array element of them is written
+		inline const std::vector<templateEntry>& getEntries() const { return _entries; }
+
+	protected:
+		// fills entriesOut and _entries, returns false if none of the bindings can be written by a template
+		bool buildEntries(const VkDescriptorSetLayoutBinding* bindings, const uint32_t bindingCount, std::vector<VkDescriptorUpdateTemplateEntry>& entriesOut);
+
+		void createTemplate(VkDevice device, VkDescriptorUpdateTemplateCreateInfo& createInfo, std::vector<VkDescriptorUpdateTemplateEntry>& entries);
+
+	protected:
+		VkDevice _device = VK_NULL_HANDLE;
+		VkDescriptorUpdateTemplate _template = VK_NULL_HANDLE;
+		std::vector<templateEntry> _entries; // sorted by binding
+		size_t _dataSize = 0u;
+	};
+}
+
+#endif // !VAL_DESCRIPTOR_UPDATE_TEMPLATE_HPP
@@ -0,0 +1,92 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_DESCRIPTOR_WRITE_BATCH_HPP
+#define VAL_DESCRIPTOR_WRITE_BATCH_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace val {
+
+	// Collects descriptor writes to any number of descriptor sets, and applies all of them with one vkUpdateDescriptorSets call in flush().
+	// A write to a descriptor that already has a pending write replaces it, so only the last write to every descriptor reaches the driver.
+	// The batch is not thread safe.
+	class descriptorWriteBatch {
+	public:
+		descriptorWriteBatch() = default;
+		descriptorWriteBatch(const descriptorWriteBatch& other) = delete;
+		descriptorWriteBatch(descriptorWriteBatch&& other) noexcept = default;
+	public:
+		void writeBuffer(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo);
+
+		void writeImage(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorType type, const VkDescriptorImageInfo& imageInfo);
+
+		// applies the pending writes, the sets must not be in use by a command buffer that is being recorded or executed
+		void flush(VkDevice device);
+
+		// drops the pending writes to the set, i.e. before it's freed
+		void discard(VkDescriptorSet set);
+
+		// drops the pending write to a single descriptor, i.e. before the resource it references is destroyed
+		void discard(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement);
+
+		// moves the pending writes to the set over to the newSet, i.e. when the set is replaced by a copy of it
+		void retarget(VkDescriptorSet set, VkDescriptorSet newSet);
+
+		inline bool empty() const { return _writes.empty(); }
+
+		inline size_t size() const { return _writes.size(); }
+
+	protected:
+		struct writeKey {
+			VkDescriptorSet set = VK_NULL_HANDLE;
+			uint32_t binding = 0u;
+			uint32_t arrayElement = 0u;
+
+			bool operator==(const writeKey& other) const {
+				return set == other.set && binding == other.binding && arrayElement == other.arrayElement;
+			}
+		};
+
+		struct writeKeyHasher {
+			size_t operator()(const writeKey& key) const;
+		};
+
+		struct pendingWrite {
+			writeKey key;
+			VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+			bool isImage = false;
+			VkDescriptorBufferInfo bufferInfo{};
+			VkDescriptorImageInfo imageInfo{};
+		};
+
+		pendingWrite& getWrite(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement);
+
+	protected:
+		std::vector<pendingWrite> _writes;
+		std::unordered_map<writeKey, size_t, writeKeyHasher> _writeIndices; // the index of the pending write to every descriptor
+	};
+}
+
+#endif // !VAL_DESCRIPTOR_WRITE_BATCH_HPP
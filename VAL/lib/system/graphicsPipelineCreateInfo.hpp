@@ -40,7 +40,19 @@ namespace val {
 
 		uint32_t subpassIndex = 0u;
 
-		renderPassManager* renderPass;
+		// if true, the pipeline isn't compiled by VAL_PROC::create, but the first time it's bound (see VAL_PROC::getGraphicsPipeline).
+		// It's layout and descriptor sets are still created up front.
+		bool compileOnFirstUse = false;
+
+		// if NULL, the pipeline is created for dynamic rendering (see renderTarget::beginRendering) against the attachment formats below,
+		// which requires VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME to be enabled in the physicalDeviceRequirements.
+		renderPassManager* renderPass = NULL;
+
+		// the formats of the attachments that the pipeline renders to with dynamic rendering, ignored if the renderPass isn't NULL.
+		// They have to match the image views that are passed to renderTarget::beginRendering.
+		std::vector<VkFormat> colorAttachmentFormats;
+		VkFormat depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+		VkFormat stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
 
 		void setRasterizer(val::rasterizerState* rasterizer);
 
@@ -21,7 +21,7 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 namespace val {
 	inline VkPipeline& graphicsPipelineCreateInfo::getVkPipeline(VAL_PROC& proc) {
-		return proc._graphicsPipelines[pipelineIdx];
+		return proc.getGraphicsPipeline(*this);
 	}
 
 	inline VkRenderPass& graphicsPipelineCreateInfo::getVkRenderPass() {
@@ -73,24 +73,14 @@ namespace val {
 		}
 
 		inline VkDeviceMemory& getMemory() {
-			return _img_memory;
+			return _img_memory.memory;
 		}
 
 		inline const uint8_t getMipLevels() {
 			return _mipLevels;
 		}
 
-		inline const void destroy() {
-			if (_img_memory) {
-				vkDestroyImage(_device, _image, NULL);
-				vkFreeMemory(_device, _img_memory, NULL);
-				_img_memory = NULL;
-			}
-			if (_pixels) {
-				stbi_image_free(_pixels);
-				_pixels = NULL;
-			}
-		}
+		void destroy();
 
 		void transitionImgLayout(VAL_PROC& proc, VkCommandBuffer cmdbuff, VkImageLayout newLayout);
 
@@ -99,9 +89,12 @@ namespace val {
 		}
 	public:
 
-		void create(VAL_PROC& proc, const std::filesystem::path path, const VkFormat& format, const uint8_t& mipLevels = 1U, const VkSampleCountFlagBits& MSAA_samples = VK_SAMPLE_COUNT_1_BIT);
+		// if a batch is passed, the upload is recorded into it and the image can't be used until the batch has been submitted
+		void create(VAL_PROC& proc, const std::filesystem::path path, const VkFormat& format, const uint8_t& mipLevels = 1U, const VkSampleCountFlagBits& MSAA_samples = VK_SAMPLE_COUNT_1_BIT,
+			uploadBatch* batch = NULL);
 
-		void generateMipmaps(VAL_PROC& proc, const uint8_t mipLevels);
+		// if no batch is passed, the blits are submitted and waited for immediately
+		void generateMipmaps(VAL_PROC& proc, const uint8_t mipLevels, uploadBatch* batch = NULL);
 
 	protected:
 
@@ -115,8 +108,9 @@ namespace val {
 		int32_t _height{}; // source image height
 		uint8_t _channels{};
 		uint8_t _mipLevels{};
-		VkDeviceMemory _img_memory{};
+		memoryAllocation _img_memory{};
 		VkDevice _device{};
+		VAL_PROC* _proc = NULL;
 	};
 }
 #endif // !VAL_IMAGE_HPP
\ No newline at end of file
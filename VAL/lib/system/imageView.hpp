@@ -53,11 +53,18 @@ namespace val {
 		VkImageView& getImageView();
 
 		const VkImageAspectFlags& getAspectFlags();
+
+		// returns the index of the view in the sampled images of the VAL_PROC's bindless set, or VAL_BINDLESS_INVALID_INDEX
+		// if it hasn't been added. Views of textures are added when they're created, if the bindless set exists.
+		inline uint32_t getBindlessIndex() const {
+			return _bindlessIdx;
+		}
 	protected:
 		VAL_PROC& _proc;  // Store a reference
 		VkImageLayout* _layout = NULL;
 		VkImageView _imgView = VK_NULL_HANDLE;
 		VkImageAspectFlags _aspectFlags{};
+		uint32_t _bindlessIdx = UINT32_MAX; // VAL_BINDLESS_INVALID_INDEX
 	};
 }
 
@@ -0,0 +1,98 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef VAL_LAYOUT_CACHE_HPP
+#define VAL_LAYOUT_CACHE_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace val {
+
+	// Deduplicates descriptor set layouts and pipeline layouts. A layout is only created once for every unique description,
+	// and every pipeline with the same description shares the handle, which also makes their pipeline layouts compatible.
+	// The layouts are owned by the cache and destroyed with it. The cache is not thread safe.
+	class layoutCache {
+	public:
+		layoutCache() = default;
+		layoutCache(const layoutCache& other) = delete;
+		~layoutCache() {
+			destroy();
+		}
+	public:
+		void create(VkDevice device);
+
+		void destroy();
+
+		// returns the layout that matches the create info, the layout is created if no matching layout exists.
+		// Create infos with a pNext chain are not deduplicated, each of them gets a layout of it's own.
+		VkDescriptorSetLayout getDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& createInfo);
+
+		// returns the pipeline layout that matches the set layouts and push constant ranges of the create info
+		VkPipelineLayout getPipelineLayout(const VkPipelineLayoutCreateInfo& createInfo);
+
+		// returns the number of sets, counted from set 0, for which the pipeline layouts are compatible: they have the same push constant
+		// ranges and identical set layouts up to that set. Sets that were bound with one of the layouts stay bound when the other one
+		// is used for those sets. Returns 0 if either layout wasn't created by the cache.
+		uint32_t getCompatibleSetCount(VkPipelineLayout layoutA, VkPipelineLayout layoutB) const;
+
+		inline size_t getDescriptorSetLayoutCount() const { return _descriptorSetLayouts.size() + _uncachedDescriptorSetLayouts.size(); }
+
+		inline size_t getPipelineLayoutCount() const { return _pipelineLayouts.size(); }
+
+	protected:
+		struct descriptorSetLayoutKey {
+			VkDescriptorSetLayoutCreateFlags flags = 0u;
+			// sorted by binding index, pImmutableSamplers is only compared against NULL
+			std::vector<VkDescriptorSetLayoutBinding> bindings;
+			// the immutable samplers of every binding that has them, in the order of the bindings
+			std::vector<VkSampler> immutableSamplers;
+
+			bool operator==(const descriptorSetLayoutKey& other) const;
+		};
+
+		struct pipelineLayoutKey {
+			VkPipelineLayoutCreateFlags flags = 0u;
+			std::vector<VkDescriptorSetLayout> setLayouts;
+			std::vector<VkPushConstantRange> pushConstantRanges;
+
+			bool operator==(const pipelineLayoutKey& other) const;
+		};
+
+		struct keyHasher {
+			size_t operator()(const descriptorSetLayoutKey& key) const;
+			size_t operator()(const pipelineLayoutKey& key) const;
+		};
+
+	protected:
+		VkDevice _device = VK_NULL_HANDLE;
+		std::unordered_map<descriptorSetLayoutKey, VkDescriptorSetLayout, keyHasher> _descriptorSetLayouts;
+		std::vector<VkDescriptorSetLayout> _uncachedDescriptorSetLayouts;
+		std::unordered_map<pipelineLayoutKey, VkPipelineLayout, keyHasher> _pipelineLayouts;
+		// the key of every pipeline layout, the keys of an unordered_map don't move when it grows
+		std::unordered_map<VkPipelineLayout, const pipelineLayoutKey*> _pipelineLayoutKeys;
+	};
+}
+
+#endif // !VAL_LAYOUT_CACHE_HPP
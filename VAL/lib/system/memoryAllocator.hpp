@@ -0,0 +1,139 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_MEMORY_ALLOCATOR_HPP
+#define VAL_MEMORY_ALLOCATOR_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <stdlib.h>
+#include <cstdint>
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+// the size of the VkDeviceMemory blocks that allocations are sub-allocated from,
+// must be a power of two. Heaps that are smaller than 8x this size will use smaller blocks.
+#ifndef VAL_MEMORY_BLOCK_SIZE
+#define VAL_MEMORY_BLOCK_SIZE (VkDeviceSize(64u) * 1024u * 1024u)
+#endif // !VAL_MEMORY_BLOCK_SIZE
+
+// the smallest range that can be sub-allocated, must be a power of two.
+// Any allocation is rounded up to a power of two that is at least this size.
+#ifndef VAL_MEMORY_MIN_ALLOCATION_SIZE
+#define VAL_MEMORY_MIN_ALLOCATION_SIZE VkDeviceSize(256u)
+#endif // !VAL_MEMORY_MIN_ALLOCATION_SIZE
+
+namespace val {
+
+	// a range of device memory that has been sub-allocated from a memoryAllocator.
+	// Resources must be bound with the offset of the allocation, i.e. vkBindBufferMemory(device, buffer, alloc.memory, alloc.offset)
+	struct memoryAllocation {
+		inline operator bool() const { return memory != VK_NULL_HANDLE; }
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0u;
+		VkDeviceSize size = 0u; // size of the range reserved for this allocation, may be larger than the requested size
+
+		// persistently mapped pointer to the start of the allocation (memory + offset),
+		// NULL if the memory is not host visible. Do not call vkMapMemory on sub-allocated memory.
+		void* mapped = NULL;
+
+		uint32_t memoryTypeIdx = UINT32_MAX;
+		uint32_t blockIdx = UINT32_MAX; // UINT32_MAX for dedicated allocations
+		uint8_t order = 0u; // buddy order of the allocation within it's block
+	};
+
+	// Sub-allocates device memory from large per-memory-type blocks using a buddy scheme,
+	// to avoid hitting maxMemoryAllocationCount and paying the cost of vkAllocateMemory for every resource.
+	// Linear (buffers) and optimal (images) resources are kept in seperate blocks to satisfy bufferImageGranularity.
+	class memoryAllocator {
+	public:
+		memoryAllocator() = default;
+		memoryAllocator(const memoryAllocator& other) = delete;
+		~memoryAllocator() {
+			destroy();
+		}
+	public:
+		// if bufferDeviceAddress is true, every VkDeviceMemory is allocated with VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+		// which buffers created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT require. The feature must be enabled on the device.
+		void create(VkPhysicalDevice physicalDevice, VkDevice device, const bool bufferDeviceAddress = false);
+
+		// frees every block, any allocation that has not been freed is invalidated
+		void destroy();
+
+		// cached lookup, the memory properties of the physical device are only queried once
+		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+		memoryAllocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, const bool linearResource);
+
+		void free(memoryAllocation& allocation);
+
+		// returns the number of live VkDeviceMemory objects owned by the allocator
+		uint32_t getDeviceMemoryCount() const;
+
+		// returns the number of bytes that have been handed out to allocations
+		VkDeviceSize getAllocatedBytes() const;
+
+		const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const;
+
+	protected:
+		struct memoryBlock {
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			void* mapped = NULL;
+			VkDeviceSize size = 0u;
+			uint32_t memoryTypeIdx = UINT32_MAX;
+			uint32_t allocationCount = 0u;
+			uint8_t maxOrder = 0u;
+			bool linear = true;
+			// free ranges of the block, indexed by order. The size of a range of order n is VAL_MEMORY_MIN_ALLOCATION_SIZE << n
+			std::vector<std::set<VkDeviceSize>> freeLists;
+		};
+
+		VkDeviceSize getBlockSize(const uint32_t memoryTypeIdx) const;
+
+		// returns the index of the new block
+		uint32_t createBlock(const uint32_t memoryTypeIdx, const bool linear);
+
+		void destroyBlock(const uint32_t blockIdx);
+
+		// returns false if the block does not have a free range of the order
+		bool allocateFromBlock(const uint32_t blockIdx, const uint8_t order, VkDeviceSize& offsetOut);
+
+		VkDeviceMemory allocateDeviceMemory(const VkDeviceSize size, const uint32_t memoryTypeIdx, void** mappedOut);
+
+	protected:
+		VkDevice _device = VK_NULL_HANDLE;
+		VkPhysicalDeviceMemoryProperties _memProperties{};
+		bool _bufferDeviceAddress = false;
+
+		// blocks that have been destroyed are left as empty slots (memory == VK_NULL_HANDLE) so that
+		// the block indices of live allocations remain valid
+		std::vector<memoryBlock> _blocks;
+
+		// key: (typeFilter << 32) | properties
+		std::unordered_map<uint64_t, uint32_t> _memoryTypeCache;
+
+		uint32_t _dedicatedAllocationCount = 0u;
+		VkDeviceSize _allocatedBytes = 0u;
+	};
+}
+
+#endif // !VAL_MEMORY_ALLOCATOR_HPP
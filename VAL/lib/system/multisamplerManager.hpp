@@ -34,7 +34,7 @@ namespace val {
 		VAL_PROC* _procVAL;
 		/********************************/
 		VkImage _colorImage = VK_NULL_HANDLE;
-		VkDeviceMemory _colorImageMemory = VK_NULL_HANDLE;
+		memoryAllocation _colorImageMemory;
 		VkImageView _colorImageView = VK_NULL_HANDLE;
 
 		VkSampleCountFlagBits _sampleCount;
@@ -55,7 +55,8 @@ namespace val {
 		variableRateShading = 1 << 2,
 		geometryShader = 1 << 3,
 		tesselationShader = 1 << 4,
-		cubeMaps = 1 << 5
+		cubeMaps = 1 << 5,
+		bindlessDescriptors = 1 << 6 // descriptor indexing, for VAL_PROC's bindless set (see val::bindlessSet)
 	};
 
 #ifndef DEVICE_FEATURE_FLAGS_DEF_ENUM_BITWISE_OPERATORS
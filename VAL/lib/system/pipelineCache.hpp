@@ -0,0 +1,76 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef VAL_PIPELINE_CACHE_HPP
+#define VAL_PIPELINE_CACHE_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <cstdint>
+#include <filesystem>
+
+namespace val {
+	class VAL_PROC; // forward declaration
+
+	namespace fs = std::filesystem;
+
+	// A VkPipelineCache that is loaded from and saved to a file, so that pipelines only have to be compiled on the first launch.
+	// The file is only loaded if it's header matches the vendor, device and pipeline cache UUID of the physical device,
+	// a cache that was written by another driver or GPU is discarded and rebuilt.
+	class pipelineCache {
+	public:
+		pipelineCache() = default;
+		pipelineCache(const pipelineCache& other) = delete;
+		~pipelineCache() {
+			destroy();
+		}
+	public:
+		// if the filepath is empty the cache is only kept in memory and never saved
+		void create(VAL_PROC& proc, const fs::path& filepath);
+
+		// saves the cache and destroys it
+		void destroy();
+
+		// writes the cache into a temporary file which then replaces the file at the filepath,
+		// so that a crash while saving never leaves a truncated cache behind. Returns false if it could not be written.
+		bool save();
+
+		inline bool isCreated() const { return _cache != VK_NULL_HANDLE; }
+
+		// returns true if the cache was loaded from the file when it was created
+		inline bool isLoadedFromDisk() const { return _loadedFromDisk; }
+
+		// returns VK_NULL_HANDLE if the cache hasn't been created, which disables caching
+		inline VkPipelineCache getVkPipelineCache() const { return _cache; }
+
+	protected:
+		// returns true if the data was written by the same driver and physical device
+		bool validateHeader(const char* data, const size_t size) const;
+
+	protected:
+		VAL_PROC* _proc = NULL;
+		VkPipelineCache _cache = VK_NULL_HANDLE;
+		fs::path _filepath;
+		bool _loadedFromDisk = false;
+	};
+}
+
+#endif // !VAL_PIPELINE_CACHE_HPP
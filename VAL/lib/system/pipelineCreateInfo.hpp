@@ -9,7 +9,7 @@
 #include <VAL/lib/system/UBO_Handle.hpp>
 #include <VAL/lib/system/pushConstantHandle.hpp>
 #include <VAL/lib/system/SSBO_Handle.hpp>
-
+#include <VAL/lib/system/descriptorBinding.hpp>
 
 #include <VAL/lib/system/sampler.hpp>
 
@@ -19,6 +19,7 @@
 namespace val {
 	class shader; // forward declaration
 	class imageView; // forward declaration
+	class descriptorUpdateTemplate; // forward declaration
 
 	void pipelineCreateInfo_loadvkCmdPushDescriptorSetKHR(VkDevice device);
 
@@ -58,14 +59,59 @@ namespace val {
 		void pushDescriptor_STORAGE_BUFFER(VAL_PROC& proc, VkCommandBuffer cmdBuffer, const uint16_t bindingIdx, SSBO_Handle& ssbo);
 		void pushDescriptor_STORAGE_BUFFER(VAL_PROC& proc, VkCommandBuffer cmdBuffer, const uint16_t bindingIdx, const uint16_t arrIndex, SSBO_Handle& ssbo);
 
+		// pushes every push descriptor of the pipeline with one call. The data must be packed as described by the
+		// template of getPushDescriptorUpdateTemplate(), with the current frame's offsets of UBOs and SSBOs that have one per frame.
+		void pushDescriptorsWithTemplate(VAL_PROC& proc, VkCommandBuffer cmdBuffer, const void* data);
+
+		// writes every binding of the frame's set of the update rate with one call, the data must be packed as described by the
+		// template of getDescriptorUpdateTemplate() of the same rate. Queued writes to the other bindings of the set are kept.
+		// The set must not be in use by the GPU, except for the static set, which is replaced by a copy (frameInFlight is ignored for it).
+		void updateDescriptorSetWithTemplate(VAL_PROC& proc, const uint8_t frameInFlight, const void* data,
+			const DESCRIPTOR_UPDATE_RATE updateRate = DESCRIPTOR_UPDATE_RATE::PER_FRAME);
+
+		// returns the template that writes every binding of the set of the update rate, it isn't created if the set has no bindings
+		const descriptorUpdateTemplate& getDescriptorUpdateTemplate(VAL_PROC& proc, const DESCRIPTOR_UPDATE_RATE updateRate = DESCRIPTOR_UPDATE_RATE::PER_FRAME) const;
+
+		const descriptorUpdateTemplate& getPushDescriptorUpdateTemplate(VAL_PROC& proc) const;
+
 		// returns true if the pipeline has a push descriptor layout, returns false if otherwise.
 		bool hasPushDescriptorLayout();
 
+		// returns the update rate of the binding, which selects the set it is in. Bindings of set 0 are PER_FRAME.
+		DESCRIPTOR_UPDATE_RATE getBindingUpdateRate(const uint32_t bindingIndex) const;
+
+		// returns true if the binding is in the static set of the pipeline (see DESCRIPTOR_UPDATE_RATE::STATIC)
+		bool isStaticBinding(const uint32_t bindingIndex) const;
+
+		// returns the set number of the bindings with the update rate (see getUpdateRateSetNo), UINT32_MAX if the pipeline has no set of the rate
+		inline uint32_t getSetNo(const DESCRIPTOR_UPDATE_RATE updateRate) const { return updateRateSetNos[(uint32_t)updateRate]; }
+
 	public:
 		std::vector<shader*> shaders;
 		uint32_t pipelineIdx = 0u;
 		uint32_t descriptorsIdx = 0u; // index of descriptor sets and layouts
-		uint32_t pushDescriptorsSetNo = UINT32_MAX; // may point to an invalid value, represented by UINT32_MAX, be careful
+		uint32_t pushDescriptorsSetNo = UINT32_MAX; // may point to an invalid value, represented by UINT32_MAX, be careful. Directly follows the highest set of the update rates if the pipeline has push descriptors
+		// the set number of every DESCRIPTOR_UPDATE_RATE, UINT32_MAX for the rates above the highest set that has bindings.
+		// Written when the descriptor set layouts are created, the sets of the update rates are numbered 0 to descriptorSetCount - 1,
+		// the sets of the rates without bindings below it are empty. The static set is the last of them.
+		uint32_t updateRateSetNos[(uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT] = { 0u, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+		uint32_t descriptorSetCount = 1u;
+		// the bindings that are outside of set 0 and their update rates
+		std::vector<std::pair<uint32_t, DESCRIPTOR_UPDATE_RATE>> bindingUpdateRates;
+		// the number of dynamic descriptors in each of the sets of the update rates, by set number
+		std::vector<uint32_t> setDynamicOffsetCounts;
+		// if true, the bindless set of the VAL_PROC (see val::bindlessSet) is added to the pipeline layout and bound with the pipeline.
+		// It's set number is written to bindlessSetNo when the layout is created, it directly follows the highest set of the update rates,
+		// or the push descriptor set if the pipeline has one.
+		bool useBindlessSet = false;
+		uint32_t bindlessSetNo = UINT32_MAX;
+		// if true, the descriptor set of every frame is written into the descriptor buffer of the VAL_PROC (see val::descriptorBufferArena)
+		// and bound by it's offset, instead of being allocated from a pool and updated through the driver. It's reset to false when the
+		// layout is created if the pipeline can't use it: without VK_EXT_descriptor_buffer, or with dynamic descriptors, push descriptors, bindings outside of set 0 or the bindless set.
+		bool useDescriptorBuffer = false;
+		// one offset of 0 for every dynamic descriptor of the sets of the update rates, in the order of their sets and bindings.
+		// These are bound whenever the descriptor set is bound without dynamic offsets.
+		std::vector<uint32_t> defaultDynamicOffsets;
 		VkPipelineBindPoint _bindPoint = VK_PIPELINE_BIND_POINT_MAX_ENUM;
 	};
 }
@@ -0,0 +1,85 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef VAL_PIPELINE_LIBRARY_CACHE_HPP
+#define VAL_PIPELINE_LIBRARY_CACHE_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+
+namespace val {
+
+	// Links graphics pipelines from four separately compiled parts with VK_EXT_graphics_pipeline_library:
+	// the vertex input interface, the pre-rasterization shaders, the fragment shader and the fragment output interface.
+	// Every part is cached by the state it was compiled from, so pipelines that only differ in one part reuse the other three,
+	// i.e. changing the blend state of a pipeline only compiles a new fragment output interface before the parts are linked.
+	// The cache is only created if the device supports the extension, otherwise pipelines are created as a whole.
+	class pipelineLibraryCache {
+	public:
+		pipelineLibraryCache() = default;
+		pipelineLibraryCache(const pipelineLibraryCache& other) = delete;
+		~pipelineLibraryCache() {
+			destroy();
+		}
+	public:
+		void create(VkDevice device, VkPipelineCache pipelineCache);
+
+		// destroys the libraries, pipelines that were linked from them remain valid
+		void destroy();
+
+		inline bool isCreated() const { return _device != VK_NULL_HANDLE; }
+
+		// splits a complete create info into it's four parts, compiles the parts that aren't cached and links them into a pipeline.
+		// This is thread safe.
+		VkPipeline link(const VkGraphicsPipelineCreateInfo& pipelineInfo);
+
+		// destroys the libraries that were compiled from the module. Must be called when a shader module is destroyed,
+		// the handle value may be reused by a new module, which would otherwise match the keys of the stale libraries.
+		void evictModule(VkShaderModule module);
+
+		size_t getLibraryCount();
+
+	protected:
+		// returns the cached library of the key, or compiles it from the partInfo
+		VkPipeline getLibrary(const VkGraphicsPipelineLibraryFlagsEXT part, const std::string& key, const VkGraphicsPipelineCreateInfo& partInfo);
+
+		struct library {
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			std::vector<VkShaderModule> modules; // the modules of the stages of the part
+		};
+
+	protected:
+		VkDevice _device = VK_NULL_HANDLE;
+		VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+
+		std::mutex _mutex;
+		// key: the part and the serialized state of the part. The pipeline layouts in the keys are owned by the layoutCache,
+		// which only destroys them with the VAL_PROC, so unlike the shader modules their handles are never reused.
+		std::unordered_map<std::string, library> _libraries;
+	};
+}
+
+#endif // !VAL_PIPELINE_LIBRARY_CACHE_HPP
@@ -0,0 +1,132 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef VAL_PIPELINE_VARIANT_CACHE_HPP
+#define VAL_PIPELINE_VARIANT_CACHE_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <VAL/lib/system/graphicsPipelineCreateInfo.hpp>
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace val {
+	class VAL_PROC; // forward declaration
+
+	// Describes a variant of a graphics pipeline. Variants share the shaders, layout and descriptor sets of the pipeline they are based on,
+	// and only differ in the values of their specialization constants and in their fixed function state.
+	// States that are NULL are inherited from the base pipeline. States that can be made dynamic (see val::DYNAMIC_STATE) are cheaper
+	// to switch with the setters of the renderTarget, without compiling a variant.
+	struct pipelineVariant {
+		// replaces the data of the specialization constant with the constantID, in the shader at shaderIdx of the base pipeline
+		struct specializationValue {
+			uint32_t shaderIdx = 0u;
+			uint32_t constantID = 0u;
+			std::vector<char> data; // must be the same size as the data of the constant
+		};
+
+		std::vector<specializationValue> specializationValues;
+		rasterizerState* rasterizer = NULL;
+		colorBlendState* colorBlend = NULL;
+		depthStencilState* depthStencil = NULL;
+	};
+
+	// Compiles pipeline variants the first time they're requested, either on the calling thread or on a background thread.
+	// The variants are keyed by their base pipeline and the contents of the variant, so equivalent variants are only compiled once.
+	class pipelineVariantCache {
+	public:
+		pipelineVariantCache() = default;
+		pipelineVariantCache(const pipelineVariantCache& other) = delete;
+		~pipelineVariantCache() {
+			destroy();
+		}
+	public:
+		void create(VAL_PROC& proc);
+
+		// waits for the background compilations to finish and destroys every variant
+		void destroy();
+
+		// returns the variant, it is compiled on the calling thread if it hasn't been compiled yet.
+		// A variant whose background compilation failed is compiled again, so that the error reaches the caller.
+		VkPipeline get(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant);
+
+		// returns the variant if it has been compiled, otherwise it's compilation is queued on the background thread and the fallback is returned.
+		// The states of the variant, the layout and the shader modules of the base are copied, so they don't have to outlive the call.
+		// The base create info itself is only referenced: it, it's shaders and it's states must stay alive and unchanged until
+		// the base pipeline is removed (see VAL_PROC::removePipeline), which drops the queued compilations of it's variants.
+		// If the compilation fails, the fallback is returned by every later call instead of queueing it again.
+		VkPipeline getAsync(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant, VkPipeline fallback);
+
+		bool isCompiled(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant);
+
+		// drops the queued compilations of the variants of the base pipeline, waits for the one that is being compiled,
+		// and moves the compiled variants into pipelinesOut. The caller destroys them once the GPU no longer uses them.
+		void removeVariantsOf(const graphicsPipelineCreateInfo& base, std::vector<VkPipeline>& pipelinesOut);
+
+		size_t getVariantCount();
+
+		// serializes the base pipeline index and every value of the variant that affects the compiled pipeline
+		static std::string buildKey(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant);
+
+	protected:
+		// owns copies of the states of the variant, which are pointed to by it's variant
+		struct compileJob {
+			std::string key;
+			const graphicsPipelineCreateInfo* base = NULL;
+			// copied on the calling thread, the containers of the VAL_PROC may be reallocated while the job is compiled
+			VkPipelineLayout layout = VK_NULL_HANDLE;
+			std::vector<VkShaderModule> shaderModules;
+			pipelineVariant variant;
+			rasterizerState rasterizer;
+			depthStencilState depthStencil;
+			colorBlendState colorBlend;
+			std::vector<colorBlendStateAttachment> blendAttachments;
+		};
+
+		void workerLoop();
+
+	protected:
+		VAL_PROC* _proc = NULL;
+
+		std::mutex _mutex;
+		std::condition_variable _jobQueued;
+		std::condition_variable _variantCompiled;
+		std::deque<std::unique_ptr<compileJob>> _jobs;
+		std::thread _worker; // started by the first asynchronous request
+		bool _stopping = false;
+
+		// the pipeline is VK_NULL_HANDLE while the variant is being compiled
+		std::unordered_map<std::string, VkPipeline> _variants;
+		// the keys of the variants whose background compilation failed, they aren't queued again
+		std::unordered_set<std::string> _failedVariants;
+	};
+}
+
+#endif // !VAL_PIPELINE_VARIANT_CACHE_HPP
@@ -21,10 +21,35 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #include <VAL/lib/system/system_utils.hpp>
 
 #include <VAL/lib/system/buffer.hpp>
+#include <VAL/lib/system/asyncUploader.hpp>
+#include <VAL/lib/system/descriptorBinding.hpp>
+
+#include <cstring>
 
 namespace val {
 	class queueManager; // forward declaration
+	class window; // forward declaration
+	class depthBuffer; // forward declaration
 	class graphicsPipelineCreateInfo; // forward declaration
+	struct pipelineVariant; // forward declaration
+
+	// the number of binds and dynamic state changes that a renderTarget has recorded into it's command buffer,
+	// and the number that it skipped because the same state was already bound
+	struct renderTargetBindStats {
+		uint32_t pipelineBinds = 0u;
+		uint32_t pipelineBindsSkipped = 0u;
+		// includes the offsets that are set in the descriptor buffer and the binds of the bindless set
+		uint32_t descriptorSetBinds = 0u;
+		uint32_t descriptorSetBindsSkipped = 0u;
+		uint32_t vertexBufferBinds = 0u;
+		uint32_t vertexBufferBindsSkipped = 0u;
+		uint32_t indexBufferBinds = 0u;
+		uint32_t indexBufferBindsSkipped = 0u;
+		// viewports, scissors and every other dynamic state
+		uint32_t dynamicStateSets = 0u;
+		uint32_t dynamicStateSetsSkipped = 0u;
+	};
+
 	class renderTarget {
 	public:
 		renderTarget() = default;
@@ -36,8 +61,33 @@ namespace val {
 
 		void rebindDescriptorSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline);
 
+		// rebinds the descriptor sets of the pipeline, which must already be bound, with the dynamic offsets. Only the sets whose
+		// offsets have changed are bound again, i.e. the PER_DRAW set if only it's offsets change (see DESCRIPTOR_UPDATE_RATE).
+		// An offset is required for every dynamic descriptor of the sets, in the order of their sets and bindings, i.e. UBO_Dynamic_Handle::getDynamicOffset().
+		// This is meant to be called between draws, to select the elements that the next draw reads. The offsets of the sets that were
+		// bound with bindDescriptorSet are ignored, those sets stay bound with their own offsets.
+		void rebindDescriptorSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const uint32_t* dynamicOffsets, const uint32_t dynamicOffsetCount);
+
+		// binds the set in place of the pipeline's set of the update rate, the pipeline must already be bound. The set must have the layout
+		// of VAL_PROC::getDescriptorSetLayout(), and an offset is required for every dynamic descriptor of it. The other sets stay bound.
+		// updatePipeline and rebindDescriptorSet bind the pipeline's own sets around it, it stays bound with it's offsets while the same pipeline
+		// is applied again. Binding another pipeline (or a variant) binds that pipeline's own set again. The pipeline's own set is bound again by passing VAL_PROC::getDescriptorSet().
+		// i.e. to bind the set of a material before it's draws:
+		//		target.updatePipeline(proc, pipeline);
+		//		target.bindDescriptorSet(proc, pipeline, val::DESCRIPTOR_UPDATE_RATE::PER_MATERIAL, material.descriptorSet);
+		void bindDescriptorSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const DESCRIPTOR_UPDATE_RATE updateRate, VkDescriptorSet descriptorSet,
+			const uint32_t* dynamicOffsets = NULL, const uint32_t dynamicOffsetCount = 0u);
+
+		// binds the set at the offset of the descriptor buffer in place of the pipeline's set, the pipeline must already be bound and use the descriptor buffer.
+		// i.e. with a set from VAL_PROC::allocateTransientDescriptorBufferSet(), to change the descriptors of the next draw.
+		void setDescriptorBufferOffset(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const VkDeviceSize offset);
+
 		void updatePipeline(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline);
 
+		// binds a variant of the pipeline, which is compiled the first time it's bound (see val::pipelineVariantCache).
+		// If compileAsync is true, the pipeline itself is bound until the variant has been compiled on a background thread.
+		void updatePipeline(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const pipelineVariant& variant, const bool compileAsync = false);
+
 		void updateViewport(VAL_PROC& proc, const VkViewport& viewport);
 
 		void updateViewport(VAL_PROC& proc, const VkViewport& viewport, const uint16_t index);
@@ -64,6 +114,51 @@ namespace val {
 
 		void updateDepthBias(VAL_PROC& proc, const float depthBiasConstant, const float depthBiasClamp, const float depthBiasSlopeFactor);
 
+		/************************************************************************************************************/
+		/* EXTENDED DYNAMIC STATE */
+		// Each state has to be in the dynamic states of the bound pipeline (see graphicsPipelineCreateInfo::setDynamicStates).
+		// The pipeline can then be drawn with any combination of them, instead of compiling a pipeline for every combination.
+
+		// Vulkan 1.3 and up, or VK_EXT_extended_dynamic_state:
+
+		void updateFrontFace(VAL_PROC& proc, const VkFrontFace frontFace);
+
+		void updateDepthTestEnable(VAL_PROC& proc, const bool enable);
+
+		void updateDepthWriteEnable(VAL_PROC& proc, const bool enable);
+
+		void updateDepthCompareOp(VAL_PROC& proc, const VkCompareOp compareOp);
+
+		void updateDepthBoundsTestEnable(VAL_PROC& proc, const bool enable);
+
+		void updateStencilTestEnable(VAL_PROC& proc, const bool enable);
+
+		void updateStencilOp(VAL_PROC& proc, const VkStencilFaceFlags faceMask, const VkStencilOp failOp, const VkStencilOp passOp, const VkStencilOp depthFailOp, const VkCompareOp compareOp);
+
+		void updateStencilReference(VAL_PROC& proc, const VkStencilFaceFlags faceMask, const uint32_t reference);
+
+		// Vulkan 1.3 and up, or VK_EXT_extended_dynamic_state2:
+
+		void updateDepthBiasEnable(VAL_PROC& proc, const bool enable);
+
+		void updatePrimitiveRestartEnable(VAL_PROC& proc, const bool enable);
+
+		void updateRasterizerDiscardEnable(VAL_PROC& proc, const bool enable);
+
+		// VK_EXT_extended_dynamic_state3:
+
+		void updatePolygonMode(VAL_PROC& proc, const TOPOLOGY_MODE polygonMode);
+
+		void updateRasterizationSamples(VAL_PROC& proc, const VkSampleCountFlagBits samples);
+
+		void updateColorBlendEnable(VAL_PROC& proc, const bool enable, const uint32_t attachment = 0u);
+
+		void updateColorBlendEnables(VAL_PROC& proc, const std::vector<VkBool32>& enables, const uint32_t firstAttachment = 0u);
+
+		void updateColorBlendEquation(VAL_PROC& proc, const VkColorBlendEquationEXT& equation, const uint32_t attachment = 0u);
+
+		void updateColorWriteMask(VAL_PROC& proc, const VkColorComponentFlags writeMask, const uint32_t attachment = 0u);
+
 		void updateBuffers(VAL_PROC& proc);
 
 		/************************************************************************************************************/
@@ -103,7 +198,25 @@ namespace val {
 
 		void endPass(VAL_PROC& proc); 
 
-		void submit(VAL_PROC& proc, std::vector<VkSemaphore> waitSemaphores, VkFence fence = VK_NULL_HANDLE);
+		// begins dynamic rendering into the attachments, without a render pass or framebuffer. Requires VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME.
+		// The graphics pipelines that are bound must be created without a render pass, against the formats of the attachments.
+		void beginRendering(VAL_PROC& proc, const VkRenderingAttachmentInfoKHR* colorAttachments, const uint32_t colorAttachmentCount,
+			const VkRenderingAttachmentInfoKHR* depthAttachment = NULL, const VkRenderingAttachmentInfoKHR* stencilAttachment = NULL);
+
+		// begins dynamic rendering into the image views, which must be in VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL and VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL.
+		// The clear values are used in the order of the color views followed by the depth view, views without a clear value are loaded.
+		// If the depthFormat has a stencil aspect the depth view is also used as the stencil attachment.
+		void beginRendering(VAL_PROC& proc, const VkImageView* colorViews, const uint32_t colorViewCount, VkImageView depthView = VK_NULL_HANDLE,
+			const VkFormat depthFormat = VK_FORMAT_UNDEFINED);
+
+		// begins dynamic rendering into the swapchain image that was acquired by window::beginDrawImage, the render area is the size of the swapchain.
+		// The image is transitioned for rendering here and for presentation in endRendering. The contents of the depth buffer are discarded.
+		void beginRendering(VAL_PROC& proc, window& wnd, depthBuffer* depth = NULL);
+
+		void endRendering(VAL_PROC& proc);
+
+		// uploadToWaitFor is a token returned by one of the async upload functions of the VAL_PROC, the draw commands will not execute before the upload has completed.
+		void submit(VAL_PROC& proc, std::vector<VkSemaphore> waitSemaphores, VkFence fence = VK_NULL_HANDLE, const uploadToken uploadToWaitFor = 0u);
 
 	public:
 		inline void setVertexBuffer(const VkBuffer& buffer, const uint32_t& vertexCount) {
@@ -111,15 +224,24 @@ namespace val {
 			_vertexCount = vertexCount;
 
 
-			_vertexBufferOffsets.resize(_vertexBuffers.size());
+			_vertexBufferOffsets.assign(_vertexBuffers.size(), 0u);
 		}
 
-		inline void setVertexBuffer(val::buffer& buffer, const uint32_t& vertexCount) {
-			_vertexBuffers = { buffer.getVkBuffer()};
+		inline void setVertexBuffer(const VkBuffer& buffer, const VkDeviceSize offset, const uint32_t& vertexCount) {
+			_vertexBuffers = { buffer };
 			_vertexCount = vertexCount;
 
 
-			_vertexBufferOffsets.resize(_vertexBuffers.size());
+			_vertexBufferOffsets = { offset };
+		}
+
+		// binds the frame of the buffer, if the buffer packs it's frames the offset of the frame is bound with it
+		inline void setVertexBuffer(val::buffer& buffer, const uint32_t& vertexCount, const uint8_t frameIdx = 0u) {
+			_vertexBuffers = { buffer.getVkBuffer(frameIdx)};
+			_vertexCount = vertexCount;
+
+
+			_vertexBufferOffsets = { buffer.getOffset(frameIdx) };
 		}
 
 		inline void setVertexBuffers(const std::vector<VkBuffer>& vertexBuffers, const uint32_t& vertexCount) {
@@ -127,18 +249,17 @@ namespace val {
 			_vertexCount = vertexCount;
 
 
-			_vertexBufferOffsets.resize(vertexBuffers.size());
+			_vertexBufferOffsets.assign(vertexBuffers.size(), 0u);
 		}
 
-		inline void setVertexBuffers(const std::vector<val::buffer*>& vertexBuffers, const uint32_t& vertexCount) {
+		inline void setVertexBuffers(const std::vector<val::buffer*>& vertexBuffers, const uint32_t& vertexCount, const uint8_t frameIdx = 0u) {
 			_vertexBuffers.resize(vertexBuffers.size());
+			_vertexBufferOffsets.resize(vertexBuffers.size());
 			for (uint_fast16_t i = 0; i < vertexBuffers.size(); ++i) {
-				_vertexBuffers[i] = vertexBuffers[i]->getVkBuffer();
+				_vertexBuffers[i] = vertexBuffers[i]->getVkBuffer(frameIdx);
+				_vertexBufferOffsets[i] = vertexBuffers[i]->getOffset(frameIdx);
 			}
 			_vertexCount = vertexCount;
-
-
-			_vertexBufferOffsets.resize(vertexBuffers.size());
 		}
 
 
@@ -146,13 +267,15 @@ namespace val {
 			return _vertexBuffers;
 		}
 
-		inline void setIndexBuffer(val::buffer& buffer, const uint32_t& indexCount) {
-			_indexBuffer = buffer.getVkBuffer();
+		inline void setIndexBuffer(val::buffer& buffer, const uint32_t& indexCount, const uint8_t frameIdx = 0u) {
+			_indexBuffer = buffer.getVkBuffer(frameIdx);
+			_indexBufferOffset = buffer.getOffset(frameIdx);
 			_indexCount = indexCount;
 		}
 
 		inline void setIndexBuffer(const VkBuffer& indexBuffer, const uint32_t& indexCount) {
 			_indexBuffer = indexBuffer;
+			_indexBufferOffset = 0u;
 			_indexCount = indexCount;
 		}
 		
@@ -219,6 +342,148 @@ namespace val {
 			return _clearValues;
 		} 
 
+		// the binds of the command buffer that is being recorded, or of the last one that was recorded. They're reset by begin().
+		inline const renderTargetBindStats& getBindStats() const {
+			return _bindStats;
+		}
+
+		// forgets what is bound in the command buffer, so that the next binds and dynamic states are recorded even if they're unchanged.
+		// This has to be called after binding pipelines, descriptor sets, buffers or dynamic state into the command buffer of the current frame
+		// without the renderTarget.
+		void invalidateBoundState();
+
+
+	protected:
+		// binds the vkPipeline, which is either the pipeline or one of it's variants, and the descriptor set of the pipeline
+		// with the default dynamic offsets if it isn't bound already
+		void bindPipeline(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, VkPipeline vkPipeline);
+
+		// binds the bindless set of the VAL_PROC if the pipeline uses it and it isn't bound at the pipeline's bindless set number already
+		void bindBindlessSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline);
+
+		// binds the sets of the update rates of the pipeline with the dynamic offsets. The sets that are already bound with the same handles
+		// and the same offsets are skipped (sets aren't shared between pipelines, so a compatible layout alone doesn't skip a bind), the others are bound with one call from the lowest to the highest set that has changed.
+		void bindDescriptorSets(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const uint32_t* dynamicOffsets);
+
+		// makes the layout the bound layout, the descriptor sets and the bindless set that aren't compatible with it are forgotten
+		void changeBoundPipelineLayout(VAL_PROC& proc, const VkPipelineLayout layout);
+
+		// forgets the bound descriptor sets from the set number on, so that they're bound again by the next bind
+		void invalidateDescriptorSets(const uint32_t firstSetNo = 0u);
+
+		// binds the vertex buffers of the renderTarget if they aren't bound already
+		void bindVertexBuffers(VAL_PROC& proc);
+
+		// binds the index buffer of the renderTarget if it has indices and it isn't bound already
+		void bindIndexBuffer(VAL_PROC& proc);
+
+		// forgets the dynamic state, which has to be set again after a different pipeline is bound
+		void invalidateDynamicState();
+
+		// counts a dynamic state change as recorded or skipped, returns changed
+		inline bool countDynamicState(const bool changed) {
+			if (changed) {
+				++_bindStats.dynamicStateSets;
+			}
+			else {
+				++_bindStats.dynamicStateSetsSkipped;
+			}
+			return changed;
+		}
+
+	protected:
+		enum DYNAMIC_STATE_SLOT : uint32_t {
+			DYNAMIC_STATE_LINE_WIDTH,
+			DYNAMIC_STATE_BLEND_CONSTANTS,
+			DYNAMIC_STATE_TOPOLOGY,
+			DYNAMIC_STATE_CULL_MODE,
+			DYNAMIC_STATE_DEPTH_BIAS,
+			DYNAMIC_STATE_FRONT_FACE,
+			DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+			DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+			DYNAMIC_STATE_DEPTH_COMPARE_OP,
+			DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE,
+			DYNAMIC_STATE_STENCIL_TEST_ENABLE,
+			DYNAMIC_STATE_STENCIL_OP_FRONT,
+			DYNAMIC_STATE_STENCIL_OP_BACK,
+			DYNAMIC_STATE_STENCIL_REFERENCE_FRONT,
+			DYNAMIC_STATE_STENCIL_REFERENCE_BACK,
+			DYNAMIC_STATE_DEPTH_BIAS_ENABLE,
+			DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE,
+			DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE,
+			DYNAMIC_STATE_POLYGON_MODE,
+			DYNAMIC_STATE_RASTERIZATION_SAMPLES
+		};
+
+		struct stencilOpState {
+			VkStencilOp failOp;
+			VkStencilOp passOp;
+			VkStencilOp depthFailOp;
+			VkCompareOp compareOp;
+		};
+
+		// the values of the dynamic states that are set in the command buffer, a value is only valid if it's slot is set in _validDynamicStates
+		struct dynamicStateValues {
+			float lineWidth;
+			std::array<float, 4> blendConstants;
+			VkPrimitiveTopology topology;
+			VkCullModeFlags cullMode;
+			std::array<float, 3> depthBias;
+			VkFrontFace frontFace;
+			VkBool32 depthTestEnable;
+			VkBool32 depthWriteEnable;
+			VkCompareOp depthCompareOp;
+			VkBool32 depthBoundsTestEnable;
+			VkBool32 stencilTestEnable;
+			stencilOpState stencilOps[2]; // front, back
+			uint32_t stencilReferences[2]; // front, back
+			VkBool32 depthBiasEnable;
+			VkBool32 primitiveRestartEnable;
+			VkBool32 rasterizerDiscardEnable;
+			VkPolygonMode polygonMode;
+			VkSampleCountFlagBits rasterizationSamples;
+		};
+
+		// state that is set by ranges of indices, i.e. viewports or the blend states of the color attachments
+		template <typename T>
+		struct boundStateRange {
+			std::vector<T> values;
+			std::vector<uint8_t> valid;
+
+			// stores the values and returns true if any of them differs from what is set in the command buffer
+			bool change(const uint32_t first, const uint32_t count, const T* newValues) {
+				if (values.size() < first + count) {
+					values.resize(first + count);
+					valid.resize(first + count, 0u);
+				}
+				bool changed = false;
+				for (uint32_t i = 0; i < count; ++i) {
+					if (!valid[first + i] || memcmp(&values[first + i], &newValues[i], sizeof(T)) != 0) {
+						values[first + i] = newValues[i];
+						valid[first + i] = 1u;
+						changed = true;
+					}
+				}
+				return changed;
+			}
+
+			void clear() {
+				values.clear();
+				valid.clear();
+			}
+		};
+
+		// stores the value and returns true if it differs from the value of the dynamic state that is set in the command buffer
+		template <typename T>
+		inline bool dynamicStateChanged(const DYNAMIC_STATE_SLOT slot, T& boundValue, const T& value) {
+			const uint32_t slotBit = 1u << slot;
+			if ((_validDynamicStates & slotBit) && memcmp(&boundValue, &value, sizeof(T)) == 0) {
+				return false;
+			}
+			boundValue = value;
+			_validDynamicStates |= slotBit;
+			return true;
+		}
 
 	protected:
 		VkRenderPass _renderPass = VK_NULL_HANDLE;
@@ -230,7 +495,40 @@ namespace val {
 		std::vector<VkDeviceSize> _vertexBufferOffsets;
 		uint32_t _vertexCount = 0;
 		VkBuffer _indexBuffer;
+		VkDeviceSize _indexBufferOffset = 0u;
 		uint32_t _indexCount = 0;
+		// the pipeline that is bound in the command buffer of the current frame
+		VkPipeline _boundPipeline = VK_NULL_HANDLE;
+		// the descriptor sets of the update rates that are bound in the command buffer of the current frame by set number, the layout
+		// they were last bound with and the dynamic offsets of each of them
+		VkPipelineLayout _boundPipelineLayout = VK_NULL_HANDLE;
+		VkDescriptorSet _boundDescriptorSets[(uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT] = {};
+		std::vector<uint32_t> _boundDynamicOffsets[(uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT];
+		// true for the sets that were bound with bindDescriptorSet, the pipeline's own sets aren't bound in their place until another pipeline is bound
+		bool _userBoundDescriptorSets[(uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT] = {};
+		// the layout and set number that the bindless set was last bound with in the command buffer of the current frame,
+		// VK_NULL_HANDLE once a layout that isn't compatible up to the set has been bound
+		VkPipelineLayout _boundBindlessLayout = VK_NULL_HANDLE;
+		uint32_t _boundBindlessSetNo = UINT32_MAX;
+		// whether the descriptor buffer of the VAL_PROC is bound in the command buffer of the current frame, and the offset of the set that is bound from it
+		bool _descriptorBufferBound = false;
+		VkDeviceSize _boundDescriptorBufferOffset = VK_WHOLE_SIZE;
+		// the vertex and index buffers that are bound in the command buffer of the current frame
+		std::vector<VkBuffer> _boundVertexBuffers;
+		std::vector<VkDeviceSize> _boundVertexBufferOffsets;
+		VkBuffer _boundIndexBuffer = VK_NULL_HANDLE;
+		VkDeviceSize _boundIndexBufferOffset = 0u;
+		// the dynamic state that is set in the command buffer of the current frame, one bit per DYNAMIC_STATE_SLOT
+		uint32_t _validDynamicStates = 0u;
+		dynamicStateValues _dynamicState{};
+		boundStateRange<VkViewport> _boundViewports;
+		boundStateRange<VkRect2D> _boundScissors;
+		boundStateRange<VkBool32> _boundColorBlendEnables;
+		boundStateRange<VkColorBlendEquationEXT> _boundColorBlendEquations;
+		boundStateRange<VkColorComponentFlags> _boundColorWriteMasks;
+		renderTargetBindStats _bindStats;
+		// the swapchain image that is being rendered to with dynamic rendering, it's transitioned for presentation by endRendering
+		VkImage _presentImage = VK_NULL_HANDLE;
 		VkRenderPassBeginInfo _renderPassBeginInfo{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO, NULL, VK_NULL_HANDLE, VK_NULL_HANDLE, {0u,0u}, 0u, VK_NULL_HANDLE};
 	};
 }
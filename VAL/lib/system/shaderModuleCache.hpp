@@ -0,0 +1,91 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef VAL_SHADER_MODULE_CACHE_HPP
+#define VAL_SHADER_MODULE_CACHE_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace val {
+
+	// identifies SPIR-V bytecode by it's size and two independent 64 bit hashes, so that the bytecode doesn't have to be kept for comparisons
+	struct shaderModuleKey {
+		uint64_t hash = 0u; // FNV-1a
+		uint64_t hash2 = 0u; // multiply-xorshift over the 32 bit words
+		size_t size = 0u; // in bytes
+
+		bool operator==(const shaderModuleKey& other) const {
+			return hash == other.hash && hash2 == other.hash2 && size == other.size;
+		}
+	};
+
+	// Reference counted VkShaderModules, keyed by the 128 bit hash and the size of their SPIR-V bytecode.
+	// Shaders with identical bytecode share one module, no matter how many shader instances or pipelines use it.
+	// The cache doesn't keep the bytecode, once a module is created it can be acquired by it's key alone,
+	// which allows the bytecode to be deleted (see shader::deleteByteCode).
+	// The cache is not thread safe.
+	class shaderModuleCache {
+	public:
+		shaderModuleCache() = default;
+		shaderModuleCache(const shaderModuleCache& other) = delete;
+		~shaderModuleCache() {
+			destroy();
+		}
+	public:
+		void create(VkDevice device);
+
+		// destroys every module, regardless of it's reference count
+		void destroy();
+
+		// returns the module of the bytecode and increments it's reference count, the module is created if it isn't cached.
+		// If the module is cached, the bytecode may be empty. Every call must be paired with a call to release().
+		VkShaderModule acquire(const shaderModuleKey& key, const char* bytecode, const size_t bytecodeSize);
+
+		// decrements the reference count of the module, and destroys it once it's no longer referenced.
+		// Returns true if the module was destroyed, after which it's handle value may be reused by a new module.
+		bool release(VkShaderModule module);
+
+		inline size_t getModuleCount() const { return _modules.size(); }
+
+		static shaderModuleKey hashByteCode(const char* bytecode, const size_t bytecodeSize);
+
+	protected:
+		struct cachedModule {
+			VkShaderModule module = VK_NULL_HANDLE;
+			uint32_t refCount = 0u;
+		};
+
+		struct keyHasher {
+			size_t operator()(const shaderModuleKey& key) const {
+				return size_t(key.hash ^ (key.hash2 * 0x9e3779b97f4a7c15ull));
+			}
+		};
+
+	protected:
+		VkDevice _device = VK_NULL_HANDLE;
+		std::unordered_map<shaderModuleKey, cachedModule, keyHasher> _modules;
+	};
+}
+
+#endif // !VAL_SHADER_MODULE_CACHE_HPP
@@ -0,0 +1,129 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_STAGING_RING_HPP
+#define VAL_STAGING_RING_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <VAL/lib/system/memoryAllocator.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// the number of bytes of staging memory that is reserved for each frame in flight
+#ifndef VAL_STAGING_RING_FRAME_SIZE
+#define VAL_STAGING_RING_FRAME_SIZE (VkDeviceSize(16u) * 1024u * 1024u)
+#endif // !VAL_STAGING_RING_FRAME_SIZE
+
+// the alignment of each write into the ring
+#ifndef VAL_STAGING_RING_ALIGNMENT
+#define VAL_STAGING_RING_ALIGNMENT VkDeviceSize(16u)
+#endif // !VAL_STAGING_RING_ALIGNMENT
+
+namespace val {
+	class VAL_PROC; // forward declaration
+
+	// A persistently mapped host visible buffer that is split into two regions per frame in flight.
+	// Uploads are written straight into the current region of the frame and the copies into their destination buffers
+	// are recorded into a command buffer of that region, which is submitted once by flush(). Uploads that are queued after
+	// the region has been submitted go into the other region of the frame, so they only wait if both regions are still in flight.
+	// A region is reclaimed when it's fence signals, which is typically long before the frame index comes around again.
+	class stagingRing {
+	public:
+		stagingRing() = default;
+		stagingRing(const stagingRing& other) = delete;
+		~stagingRing() {
+			destroy();
+		}
+	public:
+		void create(VAL_PROC& proc, const uint8_t frameCount, const VkDeviceSize frameSize = VAL_STAGING_RING_FRAME_SIZE);
+
+		// waits for all submitted copies to complete and destroys the ring
+		void destroy();
+
+		inline bool isCreated() const { return _buffer != VK_NULL_HANDLE; }
+
+		// copies size bytes of data into the current region of the frame and queues a copy into each of the dstBuffers.
+		// Returns false if the data is larger than a region, in which case nothing is queued.
+		bool queueCopy(const uint8_t frameIdx, const void* data, const VkDeviceSize size, const VkBuffer* dstBuffers, const uint32_t dstBufferCount, const VkDeviceSize dstOffset);
+
+		// copies size bytes of data into the current region of the frame and queues a single copy with one region for each of the dstOffsets,
+		// i.e. to write the same data into every frame of a packed buffer. Returns false if the data is larger than a region.
+		bool queueCopy(const uint8_t frameIdx, const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize* dstOffsets, const uint32_t dstOffsetCount);
+
+		// queues a copy between two device buffers, which is ordered with the uploads of the frame,
+		// i.e. to move the contents of a buffer that is being resized.
+		void queueBufferCopy(const uint8_t frameIdx, VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy* regions, const uint32_t regionCount);
+
+		// submits the copies that have been queued for the frame, does nothing if there are none. The next copies of the frame are
+		// recorded into it's other region.
+		void flush(const uint8_t frameIdx);
+
+		// flushes every frame and blocks until all copies have completed
+		void waitIdle();
+
+		// returns true if copies have been queued for the frame but not yet submitted
+		bool hasQueuedCopies(const uint8_t frameIdx) const;
+
+		// blocks until the copies that write to the buffer have completed, so that it can be destroyed
+		void waitForBuffer(VkBuffer buffer);
+
+		VkDeviceSize getFrameSize() const;
+
+	protected:
+		struct frameRegion {
+			VkDeviceSize base = 0u; // the offset of the region in the ring buffer
+			VkDeviceSize head = 0u; // the next free byte, relative to the start of the region
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+			bool recording = false;
+			bool inFlight = false;
+			std::vector<VkBuffer> dstBuffers; // the buffers written to by the copies of the region
+		};
+
+		// waits for the previous submission of the region and resets it's head
+		void reclaim(frameRegion& region);
+
+		void beginRecording(frameRegion& region);
+
+		void submit(frameRegion& region);
+
+		// returns the region of the frame that is recording, if the current region has been submitted the other region of the frame
+		// is reclaimed and recorded into instead
+		frameRegion& getRecordingRegion(const uint8_t frameIdx);
+
+		// copies the data into the current region of the frame, returns false if it doesn't fit in a region.
+		// ringOffsetOut is the offset of the data relative to the start of the ring buffer.
+		bool stage(const uint8_t frameIdx, const void* data, const VkDeviceSize size, VkDeviceSize& ringOffsetOut);
+
+	protected:
+		VAL_PROC* _proc = NULL;
+		VkBuffer _buffer = VK_NULL_HANDLE;
+		memoryAllocation _memory;
+		VkDeviceSize _frameSize = 0u;
+		// two regions for every frame in flight, the regions of frame n are 2n and 2n + 1
+		std::vector<frameRegion> _regions;
+		// the index (0 or 1) of the region of every frame that copies are recorded into
+		std::vector<uint8_t> _currentRegions;
+	};
+}
+
+#endif // !VAL_STAGING_RING_HPP
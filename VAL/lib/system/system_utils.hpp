@@ -76,6 +76,7 @@ DEF_ENUM_BITWISE_XOR_ASSIGN(TYPE)
 #include <VAL/lib/system/pipelineType.hpp>
 
 #include <VAL/lib/system/physicalDeviceRequirements.hpp>
+#include <VAL/lib/system/memoryAllocator.hpp>
 
 #include <VAL/lib/pipelineStateInfos/stateInfoEnums.hpp>
 
@@ -91,9 +92,30 @@ namespace val {
 		DEPTH_BIAS = VK_DYNAMIC_STATE_DEPTH_BIAS,
 		DEPTH_BOUNDS = VK_DYNAMIC_STATE_DEPTH_BOUNDS,
 		BLEND_CONSTANTS = VK_DYNAMIC_STATE_BLEND_CONSTANTS,
+		STENCIL_COMPARE_MASK = VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
+		STENCIL_WRITE_MASK = VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
+		STENCIL_REFERENCE = VK_DYNAMIC_STATE_STENCIL_REFERENCE,
 		/*Vk 1.3 and up:*/
 		CULL_MODE = VK_DYNAMIC_STATE_CULL_MODE, 
-		TOPOLOGY = VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY
+		TOPOLOGY = VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+		/*Vk 1.3 and up, or VK_EXT_extended_dynamic_state:*/
+		FRONT_FACE = VK_DYNAMIC_STATE_FRONT_FACE,
+		DEPTH_TEST_ENABLE = VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+		DEPTH_WRITE_ENABLE = VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+		DEPTH_COMPARE_OP = VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
+		DEPTH_BOUNDS_TEST_ENABLE = VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE,
+		STENCIL_TEST_ENABLE = VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE,
+		STENCIL_OP = VK_DYNAMIC_STATE_STENCIL_OP,
+		/*Vk 1.3 and up, or VK_EXT_extended_dynamic_state2:*/
+		DEPTH_BIAS_ENABLE = VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE,
+		PRIMITIVE_RESTART_ENABLE = VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE,
+		RASTERIZER_DISCARD_ENABLE = VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE,
+		/*VK_EXT_extended_dynamic_state3:*/
+		POLYGON_MODE = VK_DYNAMIC_STATE_POLYGON_MODE_EXT,
+		RASTERIZATION_SAMPLES = VK_DYNAMIC_STATE_RASTERIZATION_SAMPLES_EXT,
+		COLOR_BLEND_ENABLE = VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT,
+		COLOR_BLEND_EQUATION = VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT,
+		COLOR_WRITE_MASK = VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT
 	};
 
 	enum bufferSpace : uint8_t {
@@ -102,6 +124,7 @@ namespace val {
 	};
 
 	class VAL_PROC; // forward declaration
+	class uploadBatch; // forward declaration
 
 	namespace fs = std::filesystem;
 
@@ -177,9 +200,11 @@ namespace val {
 
 	VkImageView createImageView(VkDevice device, VkImage image, const VkFormat& format, const uint32_t& mipLevels = 1U);
 
-	VkImage createTextureImage(VAL_PROC* proc, fs::path imgFilepath, stbi_uc** pixelsOut, VkFormat format, VkDeviceMemory& textureImageMemory,
+	// the copy of the pixels is recorded into the batch, and every mip level is left in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL.
+	// If no batch is passed the copy is submitted and waited for before returning.
+	VkImage createTextureImage(VAL_PROC* proc, fs::path imgFilepath, stbi_uc** pixelsOut, VkFormat format, memoryAllocation& textureImageMemory,
 		const VkImageUsageFlagBits& additionalUsageFlagBits = VkImageUsageFlagBits(0), const uint32_t& mipLevels = 1U,
-		int* texWidthOut = NULL, int* texHeightOut = NULL, uint8_t* texChannelsOut = NULL, const bufferSpace& bufferSpace = GPU_ONLY);
+		int* texWidthOut = NULL, int* texHeightOut = NULL, uint8_t* texChannelsOut = NULL, const bufferSpace& bufferSpace = GPU_ONLY, uploadBatch* batch = NULL);
 	
 	// returns false if the file cannot be read
 	bool readByteFile(const std::string& filename, std::vector<char>* dst);
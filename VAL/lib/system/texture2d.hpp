@@ -35,9 +35,9 @@ namespace val {
 		}
 
 		texture2d(VAL_PROC& proc, std::filesystem::path srcpath, const VkFormat format,
-			const VkImageUsageFlagBits usages, const VkImageLayout layout, const bufferSpace memspace = GPU_ONLY, const uint8_t mipLevels = 1u) : _proc(proc)
+			const VkImageUsageFlagBits usages, const VkImageLayout layout, const bufferSpace memspace = GPU_ONLY, const uint8_t mipLevels = 1u, uploadBatch* batch = NULL) : _proc(proc)
 		{
-			create(srcpath, format, usages, layout, memspace, mipLevels);
+			create(srcpath, format, usages, layout, memspace, mipLevels, batch);
 		}
 	public:
 
@@ -64,14 +64,16 @@ namespace val {
 		void create(const uint16_t width, const uint16_t height, const VkFormat format, const VkImageUsageFlagBits usages,
 			const VkImageLayout layout, const bufferSpace memspace = GPU_ONLY, const uint8_t mipLevels = 0u);
 
+		// the upload and the mipmap generation are recorded into the batch, the texture can't be used until the batch has been submitted.
+		// If no batch is passed, the upload is submitted and waited for before returning.
 		void create(std::filesystem::path srcpath, const VkFormat format, const VkImageUsageFlagBits usages,
-			const VkImageLayout layout, const bufferSpace memspace = GPU_ONLY, const uint8_t mipLevels = 0u);
+			const VkImageLayout layout, const bufferSpace memspace = GPU_ONLY, const uint8_t mipLevels = 0u, uploadBatch* batch = NULL);
 
 		void destroy();
 
 	protected:
 
-		void generateMipmaps(const uint8_t mipLevels);
+		void generateMipmaps(const uint8_t mipLevels, uploadBatch& batch);
 
 	protected:
 
@@ -79,7 +81,7 @@ namespace val {
 
 		stbi_uc* _pixels = NULL;
 		VkImage _img = VK_NULL_HANDLE;
-		VkDeviceMemory _imgMemory = VK_NULL_HANDLE;
+		memoryAllocation _imgMemory;
 		VAL_PROC& _proc;
 
 		VkImageLayout _layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
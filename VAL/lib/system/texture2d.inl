@@ -60,7 +60,7 @@ namespace val {
 
 	inline VkDeviceMemory texture2d::getDeviceMemory()
 	{
-		return _imgMemory;
+		return _imgMemory.memory;
 	}
 
 	inline VkImage texture2d::getVkImage()
@@ -0,0 +1,114 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef VAL_UPLOAD_BATCH_HPP
+#define VAL_UPLOAD_BATCH_HPP
+
+#ifndef GLFW_INCLUDE_VULKAN
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#endif // !GLFW_INCLUDE_VULKAN
+
+#include <VAL/lib/system/memoryAllocator.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// the size of the staging buffers that the data of an upload batch is packed into,
+// data that is larger than this gets a staging buffer of it's own.
+#ifndef VAL_UPLOAD_BATCH_STAGING_SIZE
+#define VAL_UPLOAD_BATCH_STAGING_SIZE (VkDeviceSize(16u) * 1024u * 1024u)
+#endif // !VAL_UPLOAD_BATCH_STAGING_SIZE
+
+namespace val {
+	class VAL_PROC; // forward declaration
+
+	// Records any number of copies, blits and barriers into one command buffer on the graphics queue,
+	// which is submitted once with one fence. The data of the copies is packed into shared staging buffers
+	// that are released once the batch has completed.
+	// i.e. loading textures at startup:
+	//		val::uploadBatch batch(proc);
+	//		for (auto& tex : textures) { tex.create(path, format, usages, layout, GPU_ONLY, mipLevels, &batch); }
+	//		batch.submitAndWait();
+	class uploadBatch {
+	public:
+		uploadBatch(VAL_PROC& proc) : _proc(proc) {};
+		uploadBatch(const uploadBatch& other) = delete;
+		// commands that have not been submitted are submitted and waited for
+		~uploadBatch() {
+			destroy();
+		}
+	public:
+		// stages the data and copies it into the dstBuffer
+		void copyToBuffer(const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize dstOffset = 0u);
+
+		// stages tightly packed texels and copies them into a mip level of the image, which must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+		void copyToImage(const void* data, const VkDeviceSize size, VkImage dstImage, const uint32_t width, const uint32_t height,
+			const uint32_t mipLevel = 0u, const VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+
+		void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkDeviceSize size, const VkDeviceSize srcOffset = 0u, const VkDeviceSize dstOffset = 0u);
+
+		void transitionImageLayout(VkImage image, const VkFormat format, const VkImageLayout oldLayout, const VkImageLayout newLayout, const uint32_t mipLevels = 1u);
+
+		// expects every mip level to be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, and leaves them in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		void generateMipMaps(VkImage image, const VkFormat format, const int32_t width, const int32_t height, const uint32_t mipLevels);
+
+		void memoryBarrier(const VkPipelineStageFlags srcStage, const VkAccessFlags srcAccess, const VkPipelineStageFlags dstStage, const VkAccessFlags dstAccess);
+
+		// returns the command buffer of the batch, for recording commands that the batch doesn't wrap
+		VkCommandBuffer getVkCommandBuffer();
+
+		// submits the recorded commands without blocking, does nothing if nothing has been recorded
+		void submit();
+
+		// blocks until the submitted commands have completed and releases their staging buffers.
+		// Afterwards the batch can be used to record new commands.
+		void wait();
+
+		void submitAndWait();
+
+		inline bool isRecording() const { return _recording; }
+
+		inline bool isSubmitted() const { return _submitted; }
+
+		void destroy();
+
+	protected:
+		struct stagingBuffer {
+			VkBuffer buffer = VK_NULL_HANDLE;
+			memoryAllocation memory;
+			VkDeviceSize head = 0u;
+		};
+
+		// begins the command buffer if it isn't recording yet
+		void beginRecording();
+
+		// copies the data into a staging buffer, returns the staging buffer and the offset of the data within it.
+		// The alignment doesn't have to be a power of two, buffer to image copies align to a multiple of the texel size.
+		VkBuffer stage(const void* data, const VkDeviceSize size, VkDeviceSize& offsetOut, const VkDeviceSize alignment = 16u);
+
+	protected:
+		VAL_PROC& _proc;
+		VkCommandBuffer _commandBuffer = VK_NULL_HANDLE;
+		VkFence _fence = VK_NULL_HANDLE;
+		bool _recording = false;
+		bool _submitted = false;
+		std::vector<stagingBuffer> _stagingBuffers;
+	};
+}
+
+#endif // !VAL_UPLOAD_BATCH_HPP
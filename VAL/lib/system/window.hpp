@@ -92,12 +92,19 @@ namespace val {
 
 		void waitForFences();
 
+		// acquires the next swapchain image, and returns it's index. The swapchain is recreated if it's out of date.
+		uint32_t acquireNextImage(const VkFormat& imageFormat);
+
 		VkFramebuffer& getSwapchainFramebuffer(const VkFormat& imageFormat); // gets the swapchain framebuffer for rendering
 
 		//void createPresentQueue();
 
 		VkFramebuffer& beginDraw(const VkFormat& imageFormat);
 
+		// the equivalent of beginDraw for dynamic rendering (see renderTarget::beginRendering), which doesn't need swapchain framebuffers.
+		// Returns the index of the swapchain image to render to.
+		uint32_t beginDrawImage(const VkFormat& imageFormat);
+
 		inline VkFence& getPresentFence();
 
 		inline queueManager& getPresentQueue();
@@ -134,8 +141,9 @@ namespace val {
 		tiny_vector<VkFramebuffer, uint8_t> _swapChainFrameBuffers;
 
 		// this data is used to recreate the swap chain when it's out of date.
-		VkImageView* _swapChainAttachments;
-		uint16_t _swapChainAttachmentCount;
+		// The render pass is VK_NULL_HANDLE if the swapchain framebuffers were never created, i.e. with dynamic rendering.
+		VkImageView* _swapChainAttachments = NULL;
+		uint16_t _swapChainAttachmentCount = 0u;
 		VkRenderPass _swapChainRenderPass{};
 
 		// Because windows can be created from an existing GLFW handle,
@@ -18,9 +18,21 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #include <VAL/lib/graphics/shader.hpp>
 #include <VAL/lib/system/VAL_PROC.hpp>
 
+#include <mutex>
+#include <unordered_map>
+
 namespace val {
+	// the bytecode of every shader file that has been loaded, shared by all the shaders that loaded the file
+	struct loadedByteCode {
+		std::weak_ptr<tiny_vector<char>> byteCode;
+		fs::file_time_type writeTime;
+	};
+	static std::mutex loadedByteCodeMutex;
+	static std::unordered_map<std::string, loadedByteCode> loadedByteCodeFiles; // key: absolute filepath
+
 	bool shader::loadFromFile(fs::path filepath) {
 		_filepath = fs::absolute(filepath);
+		_byteCodeKey = shaderModuleKey{};
 #ifndef NDEBUG
 
 		if (!std::filesystem::exists(filepath)) {
@@ -30,7 +42,25 @@ namespace val {
 
 #endif // !NDEBUG
 
-		if (readByteFile(_filepath.string(), &_byteCode)) {
+		std::error_code err;
+		const fs::file_time_type writeTime = fs::last_write_time(_filepath, err);
+
+		std::lock_guard<std::mutex> lock(loadedByteCodeMutex);
+		loadedByteCode& loaded = loadedByteCodeFiles[_filepath.lexically_normal().string()];
+
+		// reuse the bytecode if another shader still holds it and the file hasn't been modified since
+		if (!err && loaded.writeTime == writeTime) {
+			if (std::shared_ptr<tiny_vector<char>> byteCode = loaded.byteCode.lock()) {
+				_byteCode = byteCode;
+				return true;
+			}
+		}
+
+		std::shared_ptr<tiny_vector<char>> byteCode = std::make_shared<tiny_vector<char>>();
+		if (readByteFile(_filepath.string(), byteCode.get())) {
+			_byteCode = byteCode;
+			loaded.byteCode = byteCode;
+			loaded.writeTime = writeTime;
 			return true;
 		}
 #ifndef  NDEBUG
@@ -38,6 +68,7 @@ namespace val {
 			printf("\nVAL: FAILED TO READ FILE FROM DISK: %ws\n", filepath.c_str());
 		}
 #endif // ! NDEBUG
+		return false;
 	}
 
 	void shader::setEntryPoint(const std::string& entryPoint) {
@@ -96,12 +127,16 @@ namespace val {
 	}
 
 	tiny_vector<char>& shader::getByteCode() noexcept {
-		return _byteCode;
+		// shaders that haven't loaded a file get bytecode of their own
+		if (!_byteCode) {
+			_byteCode = std::make_shared<tiny_vector<char>>();
+		}
+		return *_byteCode;
 	}
 
 
 	void shader::deleteByteCode() {
-		_byteCode.~tiny_vector();
+		_byteCode.reset();
 	}
 
 	const fs::path& shader::getFilepath() noexcept {
@@ -118,27 +153,41 @@ namespace val {
 
 	std::vector<VkDescriptorSetLayoutBinding>* shader::getLayoutBindings() noexcept {
 		_layoutBindings.clear();
+		appendLayoutBindings(_layoutBindings, DESCRIPTOR_UPDATE_RATE::PER_FRAME);
+		return &_layoutBindings;
+	}
 
-		uint32_t currentBindingIdx = 0;
+	std::vector<VkDescriptorSetLayoutBinding>* shader::getUpdateRateLayoutBindings(const DESCRIPTOR_UPDATE_RATE updateRate) noexcept {
+		_updateRateLayoutBindings.clear();
+		appendLayoutBindings(_updateRateLayoutBindings, updateRate);
+		return &_updateRateLayoutBindings;
+	}
 
+	void shader::appendLayoutBindings(std::vector<VkDescriptorSetLayoutBinding>& bindingsOut, const DESCRIPTOR_UPDATE_RATE updateRate) {
 		for (uint32_t i = 0; i < _UBO_Handles.size(); ++i) {
+			if (_UBO_Handles[i].updateRate != updateRate) {
+				continue;
+			}
 			VkDescriptorSetLayoutBinding uboLayoutBinding{};
 			uboLayoutBinding.binding = _UBO_Handles[i].bindingIndex;
 			uboLayoutBinding.descriptorCount = _UBO_Handles[i].values.size();
-			uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			uboLayoutBinding.descriptorType = _UBO_Handles[i].values[0]->getVkDescriptorType();
 			uboLayoutBinding.pImmutableSamplers = NULL;
 			uboLayoutBinding.stageFlags = getStageFlags();
-			_layoutBindings.push_back(uboLayoutBinding);
+			bindingsOut.push_back(uboLayoutBinding);
 		}
 
 		for (uint32_t i = 0; i < _SSBO_Handles.size(); ++i) {
+			if (_SSBO_Handles[i].updateRate != updateRate) {
+				continue;
+			}
 			VkDescriptorSetLayoutBinding ssboLayoutBinding{};
 			ssboLayoutBinding.binding = _SSBO_Handles[i].bindingIndex;
 			ssboLayoutBinding.descriptorCount = _SSBO_Handles[i].values.size();
 			ssboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			ssboLayoutBinding.pImmutableSamplers = NULL;
 			ssboLayoutBinding.stageFlags = getStageFlags();
-			_layoutBindings.push_back(ssboLayoutBinding);
+			bindingsOut.push_back(ssboLayoutBinding);
 		}
 
 
@@ -147,6 +196,9 @@ namespace val {
 
 
 		for (val::descriptorBinding<val::sampler*>& descBinding : _imageSamplers) {
+			if (descBinding.updateRate != updateRate) {
+				continue;
+			}
 #ifndef NDEBUG
 			if (descBinding.values.size()>1) {
 				printf("VAL: WARNING: descriptorBinding<val::sampler*> cannot have more than 1 value attached to it; it cannot be treated as an array!\n");
@@ -169,7 +221,7 @@ namespace val {
 			samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 			samplerLayoutBinding.pImmutableSamplers = NULL;
 			samplerLayoutBinding.stageFlags = getStageFlags();
-			_layoutBindings.push_back(samplerLayoutBinding);
+			bindingsOut.push_back(samplerLayoutBinding);
 		}
 
 		for (uint32_t i = 0; i < standaloneImageSamplers.size(); ++i) {
@@ -179,21 +231,22 @@ namespace val {
 			samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
 			samplerLayoutBinding.pImmutableSamplers = NULL;
 			samplerLayoutBinding.stageFlags = getStageFlags();
-			_layoutBindings.push_back(samplerLayoutBinding);
+			bindingsOut.push_back(samplerLayoutBinding);
 		}
 
 
 		for (uint32_t i = 0; i < _textures.size(); ++i) {
+			if (_textures[i].updateRate != updateRate) {
+				continue;
+			}
 			VkDescriptorSetLayoutBinding textureLayoutBinding{};
 			textureLayoutBinding.binding = _textures[i].bindingIndex;
 			textureLayoutBinding.descriptorCount = _textures[i].values.size();
 			textureLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
 			textureLayoutBinding.stageFlags = getStageFlags();
 			textureLayoutBinding.pImmutableSamplers = NULL;
-			_layoutBindings.push_back(textureLayoutBinding);
+			bindingsOut.push_back(textureLayoutBinding);
 		}
-
-		return &_layoutBindings;
 	}
 	
 	std::vector<VkDescriptorSetLayoutBinding>* shader::getPushDescriptorLayoutBindings() noexcept {
@@ -329,8 +382,9 @@ namespace val {
 				for (size_t j = 0; j < buffInfoArr.size(); ++j) {
 					VkDescriptorBufferInfo& buffInfo = buffInfoArr[j];
 					buffInfo.buffer = uboHDL.values[j]->getBuffer(proc);
+					// the range of a dynamic UBO is one element, which is selected by the dynamic offset
 					buffInfo.range = uboHDL.values[j]->_size;
-					buffInfo.offset = uboHDL.values[j]->_offset;
+					buffInfo.offset = uboHDL.values[j]->getOffset(frame);
 				}
 			
 			}
@@ -343,9 +397,9 @@ namespace val {
 				for (size_t j = 0; j < buffInfoArr.size(); ++j) {
 					VkDescriptorBufferInfo& buffInfo = buffInfoArr[j];
 					memset(&buffInfo, 0, sizeof(VkDescriptorBufferInfo)); // 0 out memory
-					buffInfo.buffer = ssboHDL.values[j]->getBuffers(proc)[frame];
+					buffInfo.buffer = ssboHDL.values[j]->getBuffer(proc);
 					buffInfo.range = ssboHDL.values[j]->_size;
-					buffInfo.offset = 0;
+					buffInfo.offset = ssboHDL.values[j]->getOffset(frame);
 				}
 			}
 		}
@@ -410,97 +464,47 @@ namespace val {
 		return _SSBO_Handles;
 	}
 
+	// the update functions queue their writes in the batch of the written frame (VAL_PROC::_frameDescriptorWrites), which is applied with
+	// one vkUpdateDescriptorSets call before the next command buffer of that frame is recorded (see VAL_PROC::flushDescriptorWrites). The sets of pipelines that use the descriptor buffer
+	// are queued by the frame in the same way (see descriptorBufferArena::queueBuffer)
+
 	void shader::updateImageSampler(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<sampler&, uint32_t> sampler) {
-		for (uint16_t i = 0; i < proc._MAX_FRAMES_IN_FLIGHT; ++i) {
-			VkDescriptorSet& descriptorSet = proc._descriptorSets[pipeline.pipelineIdx][i];
-
-			VkWriteDescriptorSet descriptorWrite;
-			descriptorWrite.pNext = NULL;
-			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrite.dstSet = descriptorSet;
-			descriptorWrite.dstBinding = sampler.second; // THIS MUST MATCH THE BINDING
-			descriptorWrite.dstArrayElement = 0;
-			descriptorWrite.descriptorType = (VkDescriptorType)sampler.first.getSamplerType();;
-			descriptorWrite.descriptorCount = 1;
-			descriptorWrite.pImageInfo = &sampler.first.getVkDescriptorImageInfo();
-
-			vkUpdateDescriptorSets(proc._device, 1, &descriptorWrite, 0, nullptr);
+		// the static set is shared by every frame in flight, it's only written once
+		const uint16_t frameCount = pipeline.isStaticBinding(sampler.second) ? 1u : proc._MAX_FRAMES_IN_FLIGHT;
+		for (uint16_t i = 0; i < frameCount; ++i) {
+			updateImageSamplerAtFrame(proc, pipeline, sampler, i);
 		}
 	}
 	;
 	void shader::updateImageSamplerAtFrame(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<sampler&, uint32_t> sampler, const uint8_t frameInFlight)
 	{
-		VkWriteDescriptorSet descriptorWrite;
-		descriptorWrite.pNext = NULL;
-		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrite.dstSet = pipeline.getDescriptorSets(proc)[frameInFlight];
-		descriptorWrite.dstBinding = sampler.second;
-		descriptorWrite.descriptorType = (VkDescriptorType)sampler.first.getSamplerType();
-		descriptorWrite.descriptorCount = 1;
-		descriptorWrite.dstArrayElement = 0;
-		descriptorWrite.pImageInfo = &sampler.first.getVkDescriptorImageInfo();
-		vkUpdateDescriptorSets(proc._device, 1u, &descriptorWrite, 0, NULL);
+		// THE BINDING MUST MATCH THE SHADER
+		proc.writeImageDescriptor(pipeline, frameInFlight, sampler.second, 0u,
+			(VkDescriptorType)sampler.first.getSamplerType(), sampler.first.getVkDescriptorImageInfo());
 	}
 
 	void shader::updateTexture(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<imageView&, uint32_t> texture, const uint16_t arrIdx)
 	{
-
-		for (uint16_t i = 0; i < proc._MAX_FRAMES_IN_FLIGHT; ++i) {
-			const VkDescriptorSet& descriptorSet = proc._descriptorSets[pipeline.pipelineIdx][i];
-
-			VkDescriptorImageInfo imgInfo = { NULL, texture.first.getImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-
-			VkWriteDescriptorSet descriptorWrite;
-			descriptorWrite.pNext = NULL;
-			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrite.dstSet = descriptorSet;
-			descriptorWrite.dstBinding = texture.second; // THIS MUST MATCH THE BINDING
-			descriptorWrite.dstArrayElement = arrIdx;
-			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-			descriptorWrite.descriptorCount = 1;
-			descriptorWrite.pImageInfo = &imgInfo;
-			vkUpdateDescriptorSets(proc._device, 1, &descriptorWrite, 0, nullptr);
+		const uint16_t frameCount = pipeline.isStaticBinding(texture.second) ? 1u : proc._MAX_FRAMES_IN_FLIGHT;
+		for (uint16_t i = 0; i < frameCount; ++i) {
+			updateTextureAtFrame(proc, pipeline, texture, i, arrIdx);
 		}
 	}
 
 	void shader::updateTextureAtFrame(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<imageView&, uint32_t> texture, const uint8_t frameInFlight, const uint16_t arrIdx)
 	{
-			const VkDescriptorSet& descriptorSet = proc._descriptorSets[pipeline.pipelineIdx][frameInFlight];
-
-			VkDescriptorImageInfo imgInfo = { NULL, texture.first.getImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		VkDescriptorImageInfo imgInfo = { NULL, texture.first.getImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
 
-			VkWriteDescriptorSet descriptorWrite;
-			descriptorWrite.pNext = NULL;
-			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrite.dstSet = descriptorSet;
-			descriptorWrite.dstBinding = texture.second; // THIS MUST MATCH THE BINDING
-			descriptorWrite.dstArrayElement = arrIdx;
-			descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-			descriptorWrite.descriptorCount = 1;
-			descriptorWrite.pImageInfo = &imgInfo;
-			vkUpdateDescriptorSets(proc._device, 1, &descriptorWrite, 0, nullptr);
+		// THE BINDING MUST MATCH THE SHADER
+		proc.writeImageDescriptor(pipeline, frameInFlight, texture.second, arrIdx, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, imgInfo);
 	}
 
 
 	void shader::updateUBO(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<UBO_Handle&, uint32_t> UBO, const uint16_t arrIdx)
 	{
-		for (int_fast8_t frameIdx = 0; frameIdx < proc._MAX_FRAMES_IN_FLIGHT; ++frameIdx) {
-			VkDescriptorBufferInfo buffInfo;
-			buffInfo.buffer = UBO.first.getBuffer(proc);
-			buffInfo.range = UBO.first._size;
-			buffInfo.offset = UBO.first._offset;
-
-			const VkDescriptorSet& descriptorSet = proc._descriptorSets[pipeline.pipelineIdx][frameIdx];
-
-			VkWriteDescriptorSet descriptorWrite;
-			descriptorWrite.pNext = NULL;
-			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrite.dstSet = descriptorSet;
-			descriptorWrite.dstBinding = UBO.second; // THIS MUST MATCH THE BINDING
-			descriptorWrite.dstArrayElement = arrIdx;
-			descriptorWrite.descriptorType = UBO.first.getVkDescriptorType();
-			descriptorWrite.descriptorCount = 1;
-			vkUpdateDescriptorSets(proc._device, 1, &descriptorWrite, 0, nullptr);
+		const int_fast8_t frameCount = pipeline.isStaticBinding(UBO.second) ? 1 : proc._MAX_FRAMES_IN_FLIGHT;
+		for (int_fast8_t frameIdx = 0; frameIdx < frameCount; ++frameIdx) {
+			updateUBOatFrame(proc, pipeline, UBO, frameIdx, arrIdx);
 		}
 	}
 
@@ -509,60 +513,28 @@ namespace val {
 		VkDescriptorBufferInfo buffInfo;
 		buffInfo.buffer = UBO.first.getBuffer(proc);
 		buffInfo.range = UBO.first._size;
-		buffInfo.offset = UBO.first._offset;
+		buffInfo.offset = UBO.first.getOffset(frameInFlight);
 
-		const VkDescriptorSet& descriptorSet = proc._descriptorSets[pipeline.pipelineIdx][frameInFlight];
-
-		VkWriteDescriptorSet descriptorWrite;
-		descriptorWrite.pNext = NULL;
-		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrite.dstSet = descriptorSet;
-		descriptorWrite.dstBinding = UBO.second; // THIS MUST MATCH THE BINDING
-		descriptorWrite.dstArrayElement = arrIdx;
-		descriptorWrite.descriptorType = UBO.first.getVkDescriptorType();
-		descriptorWrite.descriptorCount = 1;
-		vkUpdateDescriptorSets(proc._device, 1, &descriptorWrite, 0, nullptr);
+		// THE BINDING MUST MATCH THE SHADER
+		proc.writeBufferDescriptor(pipeline, frameInFlight, UBO.second, arrIdx, UBO.first.getVkDescriptorType(), buffInfo);
 	}
 
 	void shader::updateSSBO(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<SSBO_Handle, uint32_t> SSBO, const uint16_t arrIdx)
 	{
-		for (int_fast8_t frameIdx = 0; frameIdx < proc._MAX_FRAMES_IN_FLIGHT; ++frameIdx) {
-			VkDescriptorBufferInfo buffInfo;
-			buffInfo.buffer = SSBO.first.getBuffers(proc)[frameIdx];
-			buffInfo.range = SSBO.first._size;
-			buffInfo.offset = 0;
-
-			const VkDescriptorSet& descriptorSet = proc._descriptorSets[pipeline.pipelineIdx][frameIdx];
-
-			VkWriteDescriptorSet descriptorWrite;
-			descriptorWrite.pNext = NULL;
-			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			descriptorWrite.dstSet = descriptorSet;
-			descriptorWrite.dstBinding = SSBO.second; // THIS MUST MATCH THE BINDING
-			descriptorWrite.dstArrayElement = arrIdx;
-			descriptorWrite.descriptorType = SSBO.first.getVkDescriptorType();
-			descriptorWrite.descriptorCount = 1;
-			vkUpdateDescriptorSets(proc._device, 1, &descriptorWrite, 0, nullptr);
+		const int_fast8_t frameCount = pipeline.isStaticBinding(SSBO.second) ? 1 : proc._MAX_FRAMES_IN_FLIGHT;
+		for (int_fast8_t frameIdx = 0; frameIdx < frameCount; ++frameIdx) {
+			updateSSBOatFrame(proc, pipeline, SSBO, frameIdx, arrIdx);
 		}
 	}
 
 	void shader::updateSSBOatFrame(VAL_PROC& proc, const pipelineCreateInfo& pipeline, std::pair<SSBO_Handle, uint32_t> SSBO, const uint8_t frameInFlight, const uint16_t arrIdx)
 	{
 		VkDescriptorBufferInfo buffInfo;
-		buffInfo.buffer = SSBO.first.getBuffers(proc)[frameInFlight];
+		buffInfo.buffer = SSBO.first.getBuffer(proc);
 		buffInfo.range = SSBO.first._size;
-		buffInfo.offset = 0;
-
-		const VkDescriptorSet& descriptorSet = proc._descriptorSets[pipeline.pipelineIdx][frameInFlight];
-
-		VkWriteDescriptorSet descriptorWrite;
-		descriptorWrite.pNext = NULL;
-		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrite.dstSet = descriptorSet;
-		descriptorWrite.dstBinding = SSBO.second; // THIS MUST MATCH THE BINDING
-		descriptorWrite.dstArrayElement = arrIdx;
-		descriptorWrite.descriptorType = SSBO.first.getVkDescriptorType();
-		descriptorWrite.descriptorCount = 1;
-		vkUpdateDescriptorSets(proc._device, 1, &descriptorWrite, 0, nullptr);
+		buffInfo.offset = SSBO.first.getOffset(frameInFlight);
+
+		// THE BINDING MUST MATCH THE SHADER
+		proc.writeBufferDescriptor(pipeline, frameInFlight, SSBO.second, arrIdx, SSBO.first.getVkDescriptorType(), buffInfo);
 	}
 }
\ No newline at end of file
@@ -31,8 +31,6 @@ namespace val {
 	}
 
 	void meshTextured::cleanup(VAL_PROC& proc) {
-		VkDevice& device = proc._device;
-
 #ifndef NDEBUG
 		if (!(bool(_indexBuffer) xor bool(_vertexBuffer))) {
 			printf("VAL: Improper deallocation of Vulkan allocated memory: Index buffer or Vertex Buffer is invalid.\n\
@@ -41,11 +39,9 @@ namespace val {
 #endif // !NDEBUG
 
 		if (_indexBuffer) {
-			vkDestroyBuffer(device, _indexBuffer, NULL);
-			vkFreeMemory(device, _indexBufferMem, NULL);
+			proc.destroyBuffer(_indexBuffer, _indexBufferMem);
 
-			vkDestroyBuffer(device, _indexBuffer, NULL);
-			vkFreeMemory(device, _indexBufferMem, NULL);
+			proc.destroyBuffer(_vertexBuffer, _vertexBufferMem);
 		}
 	}
 
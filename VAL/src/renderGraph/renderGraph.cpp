@@ -1051,6 +1051,7 @@ namespace val {
 			"beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;\n"
 			"beginInfo.pInheritanceInfo = &inheritanceInfo;\n"
 			"beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;  // Or 0 if outside render pass\n\n"
+			"V_PROC.flushDescriptorWrites(); // the writes of shader::update* are only queued\n"
 			"vkBeginCommandBuffer(" + string(cmdBuffName) + "[" + getCurrentFrameIndexArgName() + "]" + ", &beginInfo);\n"
 			"\n}\n"
 		);
@@ -9,44 +9,40 @@ namespace val {
 			throw std::runtime_error("VAL: A BUFFER WITH A USAGE BIT OF CPU_GPU CANNOT BE WRITTEN TO OR READ BY THE CPU!");
 		}
 #endif // !NDEBUG
-		memcpy(proc._SSBO_DataMapped[proc._currentFrame][_index],data,_size);
+		memcpy(getData(proc), data, _size);
 	}
 
-	VkBuffer SSBO_Handle::getBuffer(VAL_PROC& proc) {
-		return proc._SSBO_Buffers[proc._currentFrame][_index];
+	void* SSBO_Handle::getData(VAL_PROC& proc) {
+		return getData(proc, proc._currentFrame);
+	}
+
+	void* SSBO_Handle::getData(VAL_PROC& proc, const uint8_t frameIdx) {
+		return (char*)_arrSubset->_dataMapped + getOffset(frameIdx);
+	}
 
+	void SSBO_Handle::resize(VAL_PROC& proc, const uint64_t size) {
+		proc.resizeSSBO(this, size);
+	}
+
+	VkBuffer SSBO_Handle::getBuffer(VAL_PROC& proc) {
+		return _arrSubset ? _arrSubset->_vkBuff : VK_NULL_HANDLE;
 	}
 
 	std::vector<VkBuffer> SSBO_Handle::getBuffers(VAL_PROC& proc) {
-		std::vector<VkBuffer> buffers;
-		for (uint_fast8_t i = 0; i < proc._MAX_FRAMES_IN_FLIGHT; ++i) {
-			buffers.push_back(proc._SSBO_Buffers[i][_index]);
-		}
-		return buffers;
+		return std::vector<VkBuffer>(proc._MAX_FRAMES_IN_FLIGHT, getBuffer(proc));
 	}
 
-	void SSBO_Handle::updateFromTempStagingBuffer(VAL_PROC& proc, void* data) {
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
-		proc.createBuffer(_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			stagingBuffer, stagingBufferMemory);
-
-		// Map memory and copy data into the staging buffer
-		void* mappedData;
-		if (vkMapMemory(proc._device, stagingBufferMemory, 0, _size, 0, &mappedData) != VK_SUCCESS) {
-			throw std::runtime_error("Failed to map staging buffer memory.");
-		}
-		memcpy(mappedData, data, _size);
-		vkUnmapMemory(proc._device, stagingBufferMemory);
+	VkDeviceSize SSBO_Handle::getOffset(const uint8_t frameIdx) const {
+		return _offset + (frameIdx * _stride);
+	}
 
-		// Copy data from staging buffer to all storage buffers for each frame
-		for (size_t i = 0; i < proc._MAX_FRAMES_IN_FLIGHT; i++) {
-			proc.copyBuffer(stagingBuffer, getBuffers(proc)[i], _size);
+	void SSBO_Handle::updateFromTempStagingBuffer(VAL_PROC& proc, void* data) {
+		// the data is written into the staging ring once, and copied to each frame of the SSBO with one copy command
+		std::vector<VkDeviceSize> offsets(proc._MAX_FRAMES_IN_FLIGHT);
+		for (uint8_t i = 0; i < proc._MAX_FRAMES_IN_FLIGHT; ++i) {
+			offsets[i] = getOffset(i);
 		}
-
-		vkDestroyBuffer(proc._device, stagingBuffer, nullptr);
-		vkFreeMemory(proc._device, stagingBufferMemory, nullptr);
+		proc.uploadToBuffer(data, _size, getBuffer(proc), offsets.data(), offsets.size());
 	}
 
 
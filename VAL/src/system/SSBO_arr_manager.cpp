@@ -0,0 +1,272 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/SSBO_arr_manager.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+#include <cstring>
+#include <algorithm>
+
+namespace val {
+
+	/***************************************************/
+	/* SSBO ARRAY SUBSET */
+
+	void ssboArraySubset::create(VAL_PROC& proc, VkBufferUsageFlags additionalUsages, bufferSpace space,
+		SSBO_Handle** ssboHandles, uint32_t ssboCount)
+	{
+		if (ssboCount == 0u) {
+			return;
+		}
+
+		_space = space;
+		// SSBOs are uploaded to and resized with copies on the GPU
+		_usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | additionalUsages;
+		_handleCount = ssboCount;
+
+		// the alignment is always a power of 2
+		const VkDeviceSize alignment = proc._physicalDeviceProperties.limits.minStorageBufferOffsetAlignment;
+		const uint8_t frameCount = proc._MAX_FRAMES_IN_FLIGHT;
+
+		_size = 0u;
+		// first calculate the offset of each SSBO, the frames of an SSBO are adjacent
+		for (uint32_t i = 0; i < ssboCount; ++i) {
+			SSBO_Handle* ssbo = ssboHandles[i];
+			ssbo->_offset = _size;
+			ssbo->_stride = (ssbo->_size + alignment - 1) & ~(alignment - 1);
+			_size += ssbo->_stride * frameCount;
+
+			ssbo->_arrSubset = this;
+		}
+
+		proc.createBuffer(_size, _usage, bufferSpaceToVkMemoryProperty(space), _vkBuff, _vkMem);
+
+		// host visible memory is persistently mapped by the memory allocator
+		_dataMapped = _vkMem.mapped;
+	}
+
+	void ssboArraySubset::destroy(VAL_PROC& proc) {
+		if (_vkBuff) {
+			proc.destroyBuffer(_vkBuff, _vkMem);
+		}
+		_vkBuff = VK_NULL_HANDLE;
+		_dataMapped = NULL;
+		_size = 0u;
+		_handleCount = 0u;
+		_freeRanges.clear();
+	}
+
+	/***************************************************/
+	/* SSBO ARRAY */
+
+	void ssboArray::create(VAL_PROC& proc, SSBO_Handle** ssboHandles, uint32_t ssboCount) {
+		append(proc, ssboHandles, ssboCount);
+	}
+
+	void ssboArray::append(VAL_PROC& proc, SSBO_Handle** ssboHandles, uint32_t ssboCount) {
+		// group the SSBOs by their buffer space and usage flags, every group gets it's own subset
+		std::vector<std::pair<bufferSpace, VkBufferUsageFlags>> keys;
+		std::vector<std::vector<SSBO_Handle*>> groups;
+		for (uint32_t i = 0; i < ssboCount; ++i) {
+			SSBO_Handle* Hdl = ssboHandles[i];
+			// the indices of released SSBOs are reused, so that the indices stay unique and compact
+			if (!_freeIndices.empty()) {
+				Hdl->_index = _freeIndices.back();
+				_freeIndices.pop_back();
+			}
+			else {
+				Hdl->_index = _nextIndex++;
+			}
+
+			size_t groupIdx = 0;
+			for (; groupIdx < keys.size(); ++groupIdx) {
+				if (keys[groupIdx].first == Hdl->_usage && keys[groupIdx].second == Hdl->_additionalUsageFlags) {
+					break;
+				}
+			}
+			if (groupIdx == keys.size()) {
+				keys.push_back({ Hdl->_usage, Hdl->_additionalUsageFlags });
+				groups.emplace_back();
+			}
+			groups[groupIdx].push_back(Hdl);
+		}
+
+		for (size_t i = 0; i < groups.size(); ++i) {
+			_subsets.emplace_back();
+			_subsets.back().create(proc, keys[i].second, keys[i].first, groups[i].data(), groups[i].size());
+		}
+	}
+
+	void ssboArray::release(VAL_PROC& proc, SSBO_Handle* Hdl) {
+		ssboArraySubset* subset = Hdl->_arrSubset;
+		if (!subset) {
+			return;
+		}
+		Hdl->_arrSubset = NULL;
+		_freeIndices.push_back(Hdl->_index);
+
+		releaseRange(proc, subset, Hdl);
+	}
+
+	void ssboArray::releaseRange(VAL_PROC& proc, ssboArraySubset* subset, const SSBO_Handle* Hdl) {
+		if (subset->_handleCount > 1u) {
+			--subset->_handleCount;
+			// frames in flight may still use the range
+			ssboArraySubset::freeRange range;
+			range.offset = Hdl->_offset;
+			range.stride = Hdl->_stride;
+			range.framesLeft = uint32_t(proc._MAX_FRAMES_IN_FLIGHT) + 1u;
+			subset->_freeRanges.push_back(range);
+			return;
+		}
+
+		// frames in flight may still read from the buffer
+		if (subset->_vkBuff) {
+			proc.retireBuffer(subset->_vkBuff, subset->_vkMem);
+		}
+
+		for (auto it = _subsets.begin(); it != _subsets.end(); ++it) {
+			if (&(*it) == subset) {
+				_subsets.erase(it);
+				break;
+			}
+		}
+	}
+
+	void ssboArray::resize(VAL_PROC& proc, SSBO_Handle* Hdl, const VkDeviceSize newStride) {
+		ssboArraySubset* oldSubset = Hdl->_arrSubset;
+		const VkBuffer oldBuffer = oldSubset->_vkBuff;
+		const void* oldDataMapped = oldSubset->_dataMapped;
+		const uint8_t frameCount = proc._MAX_FRAMES_IN_FLIGHT;
+
+		// an SSBO that is alone in it's subset gets a new buffer for the subset
+		const bool replaceBuffer = oldSubset->_handleCount == 1u;
+
+		ssboArraySubset* subset = oldSubset;
+		VkDeviceSize dstOffset = 0u;
+		VkDeviceSize dstStride = newStride;
+		if (replaceBuffer) {
+			// the new buffer has no room for the ranges of the released SSBOs
+			oldSubset->_freeRanges.clear();
+		}
+		else {
+			subset = takeFreeRange(oldSubset->_space, oldSubset->_usage, newStride, dstOffset, dstStride);
+			if (!subset) {
+				_subsets.emplace_back();
+				subset = &_subsets.back();
+				subset->_space = oldSubset->_space;
+				subset->_usage = oldSubset->_usage;
+			}
+		}
+
+		VkBuffer dstBuffer = subset->_vkBuff;
+		memoryAllocation dstMem = subset->_vkMem;
+		const bool createdBuffer = replaceBuffer || dstBuffer == VK_NULL_HANDLE;
+		if (createdBuffer) {
+			proc.createBuffer(newStride * frameCount, subset->_usage, bufferSpaceToVkMemoryProperty(subset->_space), dstBuffer, dstMem);
+		}
+
+		// copy every frame of the SSBO into the new range
+		const VkDeviceSize copySize = std::min(Hdl->_size, newStride);
+		if (copySize > 0u) {
+			std::vector<VkBufferCopy> regions;
+			for (uint8_t i = 0; i < frameCount; ++i) {
+				if (i == proc._currentFrame && oldDataMapped && dstMem.mapped) {
+					// the region of the current frame is written by the CPU, like SSBO_Handle::update does,
+					// so that the SSBO can be written to immediately after the resize
+					memcpy((char*)dstMem.mapped + dstOffset + (dstStride * i), (const char*)oldDataMapped + Hdl->getOffset(i), (size_t)copySize);
+					continue;
+				}
+				// the frames in flight may still write to their regions, so they're copied on the GPU after them
+				VkBufferCopy region{};
+				region.srcOffset = Hdl->getOffset(i);
+				region.dstOffset = dstOffset + (dstStride * i);
+				region.size = copySize;
+				regions.push_back(region);
+			}
+			// the copy is ordered before the uploads that are queued after the resize
+			if (!regions.empty() && proc._stagingRing.isCreated()) {
+				proc._stagingRing.queueBufferCopy(proc._currentFrame, oldBuffer, dstBuffer, regions.data(), regions.size());
+			}
+			else {
+				for (const VkBufferCopy& region : regions) {
+					proc.copyBuffer(oldBuffer, dstBuffer, region.size, region.srcOffset, region.dstOffset);
+				}
+			}
+		}
+
+		if (replaceBuffer) {
+			// frames in flight may still read from the old buffer
+			proc.retireBuffer(oldSubset->_vkBuff, oldSubset->_vkMem);
+		}
+		if (createdBuffer) {
+			subset->_vkBuff = dstBuffer;
+			subset->_vkMem = dstMem;
+			subset->_dataMapped = dstMem.mapped;
+			subset->_size = newStride * frameCount;
+		}
+		if (!replaceBuffer) {
+			++subset->_handleCount;
+			// the old range is reused once the frames in flight are done with it
+			releaseRange(proc, oldSubset, Hdl);
+		}
+
+		Hdl->_arrSubset = subset;
+		Hdl->_offset = dstOffset;
+		Hdl->_stride = dstStride;
+	}
+
+	ssboArraySubset* ssboArray::takeFreeRange(const bufferSpace space, const VkBufferUsageFlags usage, const VkDeviceSize minStride,
+		VkDeviceSize& offsetOut, VkDeviceSize& strideOut)
+	{
+		for (ssboArraySubset& subset : _subsets) {
+			if (subset._space != space || subset._usage != usage) {
+				continue;
+			}
+			for (size_t i = 0; i < subset._freeRanges.size(); ++i) {
+				const ssboArraySubset::freeRange& range = subset._freeRanges[i];
+				if (range.framesLeft == 0u && range.stride >= minStride) {
+					offsetOut = range.offset;
+					strideOut = range.stride;
+					subset._freeRanges[i] = subset._freeRanges.back();
+					subset._freeRanges.pop_back();
+					return &subset;
+				}
+			}
+		}
+		return NULL;
+	}
+
+	void ssboArray::nextFrame() {
+		for (ssboArraySubset& subset : _subsets) {
+			for (ssboArraySubset::freeRange& range : subset._freeRanges) {
+				if (range.framesLeft > 0u) {
+					--range.framesLeft;
+				}
+			}
+		}
+	}
+
+	void ssboArray::destroy(VAL_PROC& proc) {
+		for (ssboArraySubset& subset : _subsets) {
+			subset.destroy(proc);
+		}
+		_subsets.clear();
+		_freeIndices.clear();
+		_nextIndex = 0;
+	}
+}
@@ -0,0 +1,44 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/UBO_Dynamic_Handle.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+namespace val {
+
+	void* UBO_Dynamic_Handle::getElementData(VAL_PROC& proc, const uint32_t elementIdx) {
+		return getElementData(proc, elementIdx, proc._currentFrame);
+	}
+
+	void* UBO_Dynamic_Handle::getElementData(VAL_PROC& proc, const uint32_t elementIdx, const uint8_t frameIdx) {
+#ifndef NDEBUG
+		if (elementIdx >= _elementCount) {
+			printf("VAL: ERROR: Element %d of a dynamic UBO with %d elements is out of range!\n", elementIdx, _elementCount);
+			throw std::runtime_error("VAL: ERROR: Dynamic UBO element index out of range!");
+		}
+#endif // !NDEBUG
+		return (char*)_arrSubset->getMappedDataOfFrame(frameIdx) + _offset + getDynamicOffset(elementIdx);
+	}
+
+	void UBO_Dynamic_Handle::updateElement(VAL_PROC& proc, const void* data, const uint32_t elementIdx) {
+		memcpy(getElementData(proc, elementIdx, proc._currentFrame), data, _size);
+	}
+
+	void UBO_Dynamic_Handle::updateElement(VAL_PROC& proc, const void* data, const uint32_t elementIdx, const uint8_t frameIdx) {
+		memcpy(getElementData(proc, elementIdx, frameIdx), data, _size);
+	}
+}
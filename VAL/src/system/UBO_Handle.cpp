@@ -45,6 +45,10 @@ namespace val {
 		return _arrSubset;
 	}
 
+	uint32_t UBO_Handle::getOffset(const uint8_t frameIdx) {
+		return (frameIdx * _arrSubset->_sizePerFrame) + _offset;
+	}
+
 	VkMemoryPropertyFlags UBO_Handle::getMemoryPropertyFlags() {
 		if (GPU_ONLY) {
 			return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
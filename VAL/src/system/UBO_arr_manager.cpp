@@ -31,35 +31,43 @@ namespace val {
 		}
 
 
+		// the offset of every UBO, and of every frame, must be a multiple of minUniformBufferOffsetAlignment.
+		// The alignment is always a power of 2.
+		const size_t alignment = proc._physicalDeviceProperties.limits.minUniformBufferOffsetAlignment;
+		const auto align = [alignment](const size_t size) { return (size + alignment - 1) & ~(alignment - 1); };
+
 		size_t& sizePerFrame = _sizePerFrame;
 		sizePerFrame = 0u;
 		// first calculate the size per frame and init UBOS
 		for (uint32_t i = 0; i < uboCount; ++i) {
 			UBO_Handle* ubo = uboHandles[i];
 			ubo->_offset = sizePerFrame;
-			sizePerFrame += ubo->_size;
+			ubo->_stride = align(ubo->_size);
+			// the elements of a dynamic UBO are laid out back to back, each padded to the stride
+			sizePerFrame += ubo->_stride * ubo->_elementCount;
 
 			ubo->_arrSubset = this;
 		}
+		sizePerFrame = align(sizePerFrame);
+		_handleCount = uboCount;
 
 		const uint8_t frameCount = proc._MAX_FRAMES_IN_FLIGHT;
 		const uint64_t totalSize = sizePerFrame * frameCount;
 
 		proc.createBuffer(totalSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | additionalUsages, bufferSpaceToVkMemoryProperty(space), _vkBuff, _vkMem);
 
-		if (space == CPU_GPU) {
-			vkMapMemory(proc._device, _vkMem, 0, totalSize, 0, &_dataMapped);
-		}
+		// host visible memory is persistently mapped by the memory allocator
+		_dataMapped = _vkMem.mapped;
 
 	}
 
 	void uboArraySubset::destroy(VAL_PROC& proc) {
 		if (_vkBuff) {
-			vkFreeMemory(proc._device, _vkMem, NULL);
-			vkDestroyBuffer(proc._device, _vkBuff, NULL);
+			proc.destroyBuffer(_vkBuff, _vkMem);
 		}
 		_vkBuff = NULL;
-		_vkMem = NULL;
+		_dataMapped = NULL;
+		_handleCount = 0u;
 	}
 
 	void* uboArraySubset::getMappedDataOfFrame(const uint8_t& frameIdx) {
@@ -193,5 +201,65 @@ namespace val {
 		globalSrcTransferOnly.destroy(proc);
 		globalDstAndSrcTransfer.destroy(proc);
 		globalOther.destroy(proc);
+
+		for (uboArraySubset& subset : _appendedSubsets) {
+			subset.destroy(proc);
+		}
+		_appendedSubsets.clear();
+	}
+
+	void uboArray::append(VAL_PROC& proc, UBO_Handle** uboHandles, uint32_t uboCount) {
+		// group the UBOs by their buffer space and usage flags, every group gets it's own subset
+		std::vector<std::pair<bufferSpace, VkBufferUsageFlags>> keys;
+		std::vector<std::vector<UBO_Handle*>> groups;
+		for (uint32_t i = 0; i < uboCount; ++i) {
+			UBO_Handle* Hdl = uboHandles[i];
+
+			size_t groupIdx = 0;
+			for (; groupIdx < keys.size(); ++groupIdx) {
+				if (keys[groupIdx].first == Hdl->_space && keys[groupIdx].second == Hdl->_additionalUsageFlags) {
+					break;
+				}
+			}
+			if (groupIdx == keys.size()) {
+				keys.push_back({ Hdl->_space, Hdl->_additionalUsageFlags });
+				groups.emplace_back();
+			}
+			groups[groupIdx].push_back(Hdl);
+		}
+
+		for (size_t i = 0; i < groups.size(); ++i) {
+			_appendedSubsets.emplace_back();
+			_appendedSubsets.back().create(proc, keys[i].second, keys[i].first, groups[i].data(), groups[i].size());
+		}
+	}
+
+	void uboArray::release(VAL_PROC& proc, UBO_Handle* Hdl) {
+		uboArraySubset* subset = Hdl->_arrSubset;
+		if (!subset) {
+			return;
+		}
+		Hdl->_arrSubset = NULL;
+
+		if (subset->_handleCount > 1u) {
+			--subset->_handleCount;
+			return;
+		}
+
+		// frames in flight may still read from the buffer
+		if (subset->_vkBuff) {
+			proc.retireBuffer(subset->_vkBuff, subset->_vkMem);
+		}
+		subset->_vkBuff = VK_NULL_HANDLE;
+		subset->_dataMapped = NULL;
+		subset->_sizePerFrame = 0u;
+		subset->_handleCount = 0u;
+
+		for (auto it = _appendedSubsets.begin(); it != _appendedSubsets.end(); ++it) {
+			if (&(*it) == subset) {
+				_appendedSubsets.erase(it);
+				break;
+			}
+		}
 	}
 }
\ No newline at end of file
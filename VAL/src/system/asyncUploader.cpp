@@ -0,0 +1,396 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/asyncUploader.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+#include <stdexcept>
+#include <cstring>
+
+namespace val {
+
+	static VkSemaphore createTimelineSemaphore(VkDevice device) {
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0u;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		VkSemaphore semaphore;
+		if (vkCreateSemaphore(device, &semaphoreInfo, NULL, &semaphore) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to create timeline semaphore for the async uploader!");
+		}
+		return semaphore;
+	}
+
+	void asyncUploader::create(VAL_PROC& proc) {
+		_proc = &proc;
+		_transferFamily = proc._transferQueue._queueFamily;
+		_graphicsFamily = proc._graphicsQueue._queueFamily;
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = _transferFamily;
+
+		if (vkCreateCommandPool(proc._device, &poolInfo, NULL, &_transferCommandPool) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to create transfer command pool!");
+		}
+
+		_timeline = createTimelineSemaphore(proc._device);
+		_acquireTimeline = createTimelineSemaphore(proc._device);
+		_timelineValue = 0u;
+		_acquireTimelineValue = 0u;
+		_lastAcquiredToken = 0u;
+	}
+
+	void asyncUploader::destroy() {
+		if (!isCreated()) {
+			return;
+		}
+
+		wait(_timelineValue);
+
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &_acquireTimeline;
+		waitInfo.pValues = &_acquireTimelineValue;
+		vkWaitSemaphores(_proc->_device, &waitInfo, UINT64_MAX);
+
+		collect();
+
+		vkDestroySemaphore(_proc->_device, _timeline, NULL);
+		vkDestroySemaphore(_proc->_device, _acquireTimeline, NULL);
+		_timeline = VK_NULL_HANDLE;
+		_acquireTimeline = VK_NULL_HANDLE;
+
+		vkDestroyCommandPool(_proc->_device, _transferCommandPool, NULL);
+		_transferCommandPool = VK_NULL_HANDLE;
+
+		_pendingAcquires.clear();
+		_proc = NULL;
+	}
+
+	uploadToken asyncUploader::uploadBuffer(const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize dstOffset /*DEFAULT = 0u*/) {
+		collect();
+
+		submission upload;
+		createStagingBuffer(data, size, upload);
+		upload.commandBuffer = beginCommandBuffer(_transferCommandPool);
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = 0u;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(upload.commandBuffer, upload.stagingBuffer, dstBuffer, 1, &copyRegion);
+
+		upload.value = ++_timelineValue;
+
+		if (requiresOwnershipTransfer()) {
+			// release the ownership of the buffer to the graphics queue family
+			VkBufferMemoryBarrier release{};
+			release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			release.dstAccessMask = 0;
+			release.srcQueueFamilyIndex = _transferFamily;
+			release.dstQueueFamilyIndex = _graphicsFamily;
+			release.buffer = dstBuffer;
+			release.offset = dstOffset;
+			release.size = size;
+			vkCmdPipelineBarrier(upload.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				0, 0, NULL, 1, &release, 0, NULL);
+
+			pendingAcquire acquireInfo;
+			acquireInfo.token = upload.value;
+			acquireInfo.buffer = dstBuffer;
+			acquireInfo.offset = dstOffset;
+			acquireInfo.size = size;
+			_pendingAcquires.push_back(acquireInfo);
+		}
+
+		if (vkEndCommandBuffer(upload.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to record async upload command buffer!");
+		}
+		submit(_proc->_transferQueue._queue, upload.commandBuffer, _timeline, upload.value);
+
+		_uploadsInFlight.push_back(upload);
+		return upload.value;
+	}
+
+	uploadToken asyncUploader::uploadImage(const void* data, const VkDeviceSize size, VkImage dstImage, const uint32_t width, const uint32_t height,
+		const VkImageLayout finalLayout /*DEFAULT = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL*/, const VkImageAspectFlags aspect /*DEFAULT = VK_IMAGE_ASPECT_COLOR_BIT*/)
+	{
+		collect();
+
+		submission upload;
+		createStagingBuffer(data, size, upload);
+		upload.commandBuffer = beginCommandBuffer(_transferCommandPool);
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = dstImage;
+		barrier.subresourceRange.aspectMask = aspect;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+		vkCmdPipelineBarrier(upload.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, NULL, 0, NULL, 1, &barrier);
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = aspect;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { width, height, 1 };
+		vkCmdCopyBufferToImage(upload.commandBuffer, upload.stagingBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		upload.value = ++_timelineValue;
+
+		// transition to the final layout, if the families differ this is the release half of the ownership transfer
+		// and the acquire barrier of the graphics queue must perform the same transition.
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = finalLayout;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		if (requiresOwnershipTransfer()) {
+			barrier.srcQueueFamilyIndex = _transferFamily;
+			barrier.dstQueueFamilyIndex = _graphicsFamily;
+
+			pendingAcquire acquireInfo;
+			acquireInfo.token = upload.value;
+			acquireInfo.image = dstImage;
+			acquireInfo.finalLayout = finalLayout;
+			acquireInfo.aspect = aspect;
+			_pendingAcquires.push_back(acquireInfo);
+		}
+		vkCmdPipelineBarrier(upload.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			0, 0, NULL, 0, NULL, 1, &barrier);
+
+		if (vkEndCommandBuffer(upload.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to record async upload command buffer!");
+		}
+		submit(_proc->_transferQueue._queue, upload.commandBuffer, _timeline, upload.value);
+
+		_uploadsInFlight.push_back(upload);
+		return upload.value;
+	}
+
+	void asyncUploader::acquire(const uploadToken token) {
+		// the graphics queue has already waited for a later upload
+		if (token == 0u || token <= _lastAcquiredToken) {
+			return;
+		}
+
+#ifndef NDEBUG
+		if (token > _timelineValue) {
+			dbg::printError("Cannot acquire upload token %llu, the most recent upload has a token of %llu.\n", (unsigned long long)token, (unsigned long long)_timelineValue);
+			throw std::runtime_error("VAL: Attempted to acquire an upload that has not been submitted!");
+		}
+#endif // !NDEBUG
+
+		collect();
+
+		submission acquireSubmission;
+		acquireSubmission.commandBuffer = beginCommandBuffer(_proc->_commandPool);
+
+		// the semaphore wait only applies to the batch that it is submitted with,
+		// this barrier extends it to everything that is submitted to the graphics queue afterwards.
+		VkMemoryBarrier memoryBarrier{};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+		std::vector<VkBufferMemoryBarrier> bufferBarriers;
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+
+		for (size_t i = 0; i < _pendingAcquires.size();) {
+			const pendingAcquire& pending = _pendingAcquires[i];
+			if (pending.token > token) {
+				++i;
+				continue;
+			}
+
+			if (pending.buffer) {
+				VkBufferMemoryBarrier acquireBarrier{};
+				acquireBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				acquireBarrier.srcAccessMask = 0;
+				acquireBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+				acquireBarrier.srcQueueFamilyIndex = _transferFamily;
+				acquireBarrier.dstQueueFamilyIndex = _graphicsFamily;
+				acquireBarrier.buffer = pending.buffer;
+				acquireBarrier.offset = pending.offset;
+				acquireBarrier.size = pending.size;
+				bufferBarriers.push_back(acquireBarrier);
+			}
+			else {
+				VkImageMemoryBarrier acquireBarrier{};
+				acquireBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				acquireBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				acquireBarrier.newLayout = pending.finalLayout;
+				acquireBarrier.srcAccessMask = 0;
+				acquireBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+				acquireBarrier.srcQueueFamilyIndex = _transferFamily;
+				acquireBarrier.dstQueueFamilyIndex = _graphicsFamily;
+				acquireBarrier.image = pending.image;
+				acquireBarrier.subresourceRange.aspectMask = pending.aspect;
+				acquireBarrier.subresourceRange.baseMipLevel = 0;
+				acquireBarrier.subresourceRange.levelCount = 1;
+				acquireBarrier.subresourceRange.baseArrayLayer = 0;
+				acquireBarrier.subresourceRange.layerCount = 1;
+				imageBarriers.push_back(acquireBarrier);
+			}
+
+			_pendingAcquires[i] = _pendingAcquires.back();
+			_pendingAcquires.pop_back();
+		}
+
+		vkCmdPipelineBarrier(acquireSubmission.commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+			1, &memoryBarrier, bufferBarriers.size(), bufferBarriers.data(), imageBarriers.size(), imageBarriers.data());
+
+		if (vkEndCommandBuffer(acquireSubmission.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to record upload acquire command buffer!");
+		}
+
+		acquireSubmission.value = ++_acquireTimelineValue;
+		submit(_proc->_graphicsQueue._queue, acquireSubmission.commandBuffer, _acquireTimeline, acquireSubmission.value, _timeline, token);
+
+		_acquiresInFlight.push_back(acquireSubmission);
+		_lastAcquiredToken = token;
+	}
+
+	bool asyncUploader::isComplete(const uploadToken token) {
+		uint64_t value = 0u;
+		vkGetSemaphoreCounterValue(_proc->_device, _timeline, &value);
+		return value >= token;
+	}
+
+	void asyncUploader::wait(const uploadToken token) {
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &_timeline;
+		waitInfo.pValues = &token;
+
+		vkWaitSemaphores(_proc->_device, &waitInfo, UINT64_MAX);
+	}
+
+	uploadToken asyncUploader::getLastToken() const {
+		return _timelineValue;
+	}
+
+	VkCommandBuffer asyncUploader::beginCommandBuffer(VkCommandPool pool) {
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = pool;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer;
+		if (vkAllocateCommandBuffers(_proc->_device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to allocate async upload command buffer!");
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+		return commandBuffer;
+	}
+
+	void asyncUploader::submit(VkQueue queue, VkCommandBuffer commandBuffer, VkSemaphore signalSemaphore, const uint64_t signalValue,
+		VkSemaphore waitSemaphore /*DEFAULT = VK_NULL_HANDLE*/, const uint64_t waitValue /*DEFAULT = 0u*/)
+	{
+		const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = waitSemaphore ? 1 : 0;
+		timelineInfo.pWaitSemaphoreValues = &waitValue;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.waitSemaphoreCount = waitSemaphore ? 1 : 0;
+		submitInfo.pWaitSemaphores = &waitSemaphore;
+		submitInfo.pWaitDstStageMask = &waitStage;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &signalSemaphore;
+
+		if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to submit async upload command buffer!");
+		}
+	}
+
+	void asyncUploader::createStagingBuffer(const void* data, const VkDeviceSize size, submission& submissionOut) {
+		_proc->createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			submissionOut.stagingBuffer, submissionOut.stagingMemory);
+		memcpy(submissionOut.stagingMemory.mapped, data, (size_t)size);
+	}
+
+	void asyncUploader::collect() {
+		uint64_t completedUploads = 0u;
+		uint64_t completedAcquires = 0u;
+		vkGetSemaphoreCounterValue(_proc->_device, _timeline, &completedUploads);
+		vkGetSemaphoreCounterValue(_proc->_device, _acquireTimeline, &completedAcquires);
+
+		for (size_t i = 0; i < _uploadsInFlight.size();) {
+			submission& upload = _uploadsInFlight[i];
+			if (upload.value > completedUploads) {
+				++i;
+				continue;
+			}
+			vkFreeCommandBuffers(_proc->_device, _transferCommandPool, 1, &upload.commandBuffer);
+			_proc->destroyBuffer(upload.stagingBuffer, upload.stagingMemory);
+
+			_uploadsInFlight[i] = _uploadsInFlight.back();
+			_uploadsInFlight.pop_back();
+		}
+
+		for (size_t i = 0; i < _acquiresInFlight.size();) {
+			submission& acquireSubmission = _acquiresInFlight[i];
+			if (acquireSubmission.value > completedAcquires) {
+				++i;
+				continue;
+			}
+			vkFreeCommandBuffers(_proc->_device, _proc->_commandPool, 1, &acquireSubmission.commandBuffer);
+
+			_acquiresInFlight[i] = _acquiresInFlight.back();
+			_acquiresInFlight.pop_back();
+		}
+	}
+}
@@ -0,0 +1,226 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/bindlessSet.hpp>
+#include <VAL/lib/debugReporting/debugCallbacks.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace val {
+
+	void bindlessSet::create(VkPhysicalDevice physicalDevice, VkDevice device, descriptorWriteBatch& writes, const uint32_t retireFrames) {
+		_device = device;
+		_writes = &writes;
+		_retireFrames = retireFrames;
+
+		VkPhysicalDeviceVulkan12Properties properties12{};
+		properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+		VkPhysicalDeviceProperties2 properties{};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties.pNext = &properties12;
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+		// the arrays are accessible from every stage, so the per stage limits apply to them too
+		_arrays[(uint32_t)BINDLESS_BINDING::SAMPLED_IMAGES].capacity = std::min({ VAL_BINDLESS_MAX_SAMPLED_IMAGES,
+			properties12.maxDescriptorSetUpdateAfterBindSampledImages, properties12.maxPerStageDescriptorUpdateAfterBindSampledImages });
+		_arrays[(uint32_t)BINDLESS_BINDING::SAMPLERS].capacity = std::min({ VAL_BINDLESS_MAX_SAMPLERS,
+			properties12.maxDescriptorSetUpdateAfterBindSamplers, properties12.maxPerStageDescriptorUpdateAfterBindSamplers });
+		_arrays[(uint32_t)BINDLESS_BINDING::STORAGE_BUFFERS].capacity = std::min({ VAL_BINDLESS_MAX_STORAGE_BUFFERS,
+			properties12.maxDescriptorSetUpdateAfterBindStorageBuffers, properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+
+		const VkDescriptorType types[] = { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VK_DESCRIPTOR_TYPE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER };
+
+		VkDescriptorSetLayoutBinding bindings[(uint32_t)BINDLESS_BINDING::BINDING_COUNT]{};
+		VkDescriptorBindingFlags bindingFlags[(uint32_t)BINDLESS_BINDING::BINDING_COUNT]{};
+		VkDescriptorPoolSize poolSizes[(uint32_t)BINDLESS_BINDING::BINDING_COUNT]{};
+		for (uint32_t i = 0; i < (uint32_t)BINDLESS_BINDING::BINDING_COUNT; ++i) {
+			bindings[i].binding = i;
+			bindings[i].descriptorType = types[i];
+			bindings[i].descriptorCount = _arrays[i].capacity;
+			bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+
+			// descriptors that no draw in flight uses can be written while the set is bound, and unused indices may hold no descriptor
+			bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+				VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+
+			poolSizes[i].type = types[i];
+			poolSizes[i].descriptorCount = _arrays[i].capacity;
+		}
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+		bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		bindingFlagsInfo.bindingCount = (uint32_t)BINDLESS_BINDING::BINDING_COUNT;
+		bindingFlagsInfo.pBindingFlags = bindingFlags;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.pNext = &bindingFlagsInfo;
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		layoutInfo.bindingCount = (uint32_t)BINDLESS_BINDING::BINDING_COUNT;
+		layoutInfo.pBindings = bindings;
+
+		if (vkCreateDescriptorSetLayout(_device, &layoutInfo, NULL, &_layout) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to create the bindless descriptor set layout!");
+		}
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolInfo.maxSets = 1u;
+		poolInfo.poolSizeCount = (uint32_t)BINDLESS_BINDING::BINDING_COUNT;
+		poolInfo.pPoolSizes = poolSizes;
+
+		if (vkCreateDescriptorPool(_device, &poolInfo, NULL, &_pool) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to create the bindless descriptor pool!");
+		}
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = _pool;
+		allocInfo.descriptorSetCount = 1u;
+		allocInfo.pSetLayouts = &_layout;
+
+		if (vkAllocateDescriptorSets(_device, &allocInfo, &_set) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to allocate the bindless descriptor set!");
+		}
+
+#ifndef NDEBUG
+		dbg::printNote("VAL: Created bindless descriptor set\n     Sampled Images: %u, Samplers: %u, Storage Buffers: %u\n",
+			_arrays[0].capacity, _arrays[1].capacity, _arrays[2].capacity);
+#endif // !NDEBUG
+	}
+
+	void bindlessSet::destroy() {
+		if (_device == VK_NULL_HANDLE) {
+			return;
+		}
+
+		if (_set != VK_NULL_HANDLE) {
+			// the queued writes would write to a freed set
+			_writes->discard(_set);
+			_set = VK_NULL_HANDLE;
+		}
+		if (_pool != VK_NULL_HANDLE) {
+			vkDestroyDescriptorPool(_device, _pool, NULL);
+			_pool = VK_NULL_HANDLE;
+		}
+		if (_layout != VK_NULL_HANDLE) {
+			vkDestroyDescriptorSetLayout(_device, _layout, NULL);
+			_layout = VK_NULL_HANDLE;
+		}
+
+		for (indexArray& arr : _arrays) {
+			arr = indexArray{};
+		}
+		_writes = NULL;
+		_device = VK_NULL_HANDLE;
+	}
+
+	uint32_t bindlessSet::addSampledImage(VkImageView imageView, const VkImageLayout layout /*DEFAULT = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL*/) {
+		const uint32_t index = acquireIndex(BINDLESS_BINDING::SAMPLED_IMAGES);
+		if (index != VAL_BINDLESS_INVALID_INDEX) {
+			updateSampledImage(index, imageView, layout);
+		}
+		return index;
+	}
+
+	uint32_t bindlessSet::addSampler(VkSampler sampler) {
+		const uint32_t index = acquireIndex(BINDLESS_BINDING::SAMPLERS);
+		if (index != VAL_BINDLESS_INVALID_INDEX) {
+			const VkDescriptorImageInfo imageInfo{ sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED };
+			_writes->writeImage(_set, (uint32_t)BINDLESS_BINDING::SAMPLERS, index, VK_DESCRIPTOR_TYPE_SAMPLER, imageInfo);
+		}
+		return index;
+	}
+
+	uint32_t bindlessSet::addStorageBuffer(VkBuffer buffer, const VkDeviceSize offset /*DEFAULT = 0u*/, const VkDeviceSize range /*DEFAULT = VK_WHOLE_SIZE*/) {
+		const uint32_t index = acquireIndex(BINDLESS_BINDING::STORAGE_BUFFERS);
+		if (index != VAL_BINDLESS_INVALID_INDEX) {
+			updateStorageBuffer(index, buffer, offset, range);
+		}
+		return index;
+	}
+
+	void bindlessSet::updateSampledImage(const uint32_t index, VkImageView imageView, const VkImageLayout layout /*DEFAULT = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL*/) {
+		const VkDescriptorImageInfo imageInfo{ VK_NULL_HANDLE, imageView, layout };
+		_writes->writeImage(_set, (uint32_t)BINDLESS_BINDING::SAMPLED_IMAGES, index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, imageInfo);
+	}
+
+	void bindlessSet::updateStorageBuffer(const uint32_t index, VkBuffer buffer, const VkDeviceSize offset /*DEFAULT = 0u*/, const VkDeviceSize range /*DEFAULT = VK_WHOLE_SIZE*/) {
+		const VkDescriptorBufferInfo bufferInfo{ buffer, offset, range };
+		_writes->writeBuffer(_set, (uint32_t)BINDLESS_BINDING::STORAGE_BUFFERS, index, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, bufferInfo);
+	}
+
+	void bindlessSet::remove(const BINDLESS_BINDING binding, const uint32_t index) {
+		if (index == VAL_BINDLESS_INVALID_INDEX) {
+			return;
+		}
+
+		indexArray& arr = _arrays[(uint32_t)binding];
+#ifndef NDEBUG
+		if (index >= arr.nextIndex) {
+			dbg::printWarning("VAL: Bindless index %u of binding %u was never added, it can't be removed\n", index, (uint32_t)binding);
+			return;
+		}
+#endif // !NDEBUG
+
+		// a write that hasn't been flushed yet would reference a resource that is about to be destroyed
+		_writes->discard(_set, (uint32_t)binding, index);
+
+		// the stale descriptor stays in the set, the partially bound arrays allow that as long as no shader reads it
+		arr.retiredIndices.push_back({ index, _retireFrames });
+	}
+
+	void bindlessSet::nextFrame() {
+		for (indexArray& arr : _arrays) {
+			for (size_t i = 0; i < arr.retiredIndices.size();) {
+				retiredIndex& retired = arr.retiredIndices[i];
+				if (--retired.framesLeft == 0u) {
+					arr.freeIndices.push_back(retired.index);
+					retired = arr.retiredIndices.back();
+					arr.retiredIndices.pop_back();
+				}
+				else {
+					++i;
+				}
+			}
+		}
+	}
+
+	void bindlessSet::bind(VkCommandBuffer cmdBuffer, const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const uint32_t setNo) const {
+		vkCmdBindDescriptorSets(cmdBuffer, bindPoint, pipelineLayout, setNo, 1u, &_set, 0u, NULL);
+	}
+
+	uint32_t bindlessSet::acquireIndex(const BINDLESS_BINDING binding) {
+		indexArray& arr = _arrays[(uint32_t)binding];
+
+		if (!arr.freeIndices.empty()) {
+			const uint32_t index = arr.freeIndices.back();
+			arr.freeIndices.pop_back();
+			return index;
+		}
+
+		if (arr.nextIndex < arr.capacity) {
+			return arr.nextIndex++;
+		}
+
+		dbg::printError("VAL: The bindless array of binding %u is full (%u descriptors), increase it's VAL_BINDLESS_MAX_* size\n", (uint32_t)binding, arr.capacity);
+		return VAL_BINDLESS_INVALID_INDEX;
+	}
+}
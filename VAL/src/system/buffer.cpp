@@ -18,24 +18,45 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 #include <VAL/lib/system/buffer.hpp>
 #include <VAL/lib/system/VAL_PROC.hpp>
+#include <VAL/lib/system/uploadBatch.hpp>
 
 namespace val
 {
-	void buffer::create(VAL_PROC& proc, const uint32_t& size, const bufferSpace& space, VkBufferUsageFlags bufferUsage, uint16_t frameCount) {
+	void buffer::create(VAL_PROC& proc, const uint32_t& size, const bufferSpace& space, VkBufferUsageFlags bufferUsage, uint16_t frameCount, const bool packFrames /*DEFAULT = false*/) {
 		_proc = proc;
 		_size = size;
 		_space = space;
 		_usage = bufferUsage;
+		_frameCount = frameCount;
+		_packed = packFrames;
 		
 		_buffers.resize(frameCount);
-		_memory.resize(frameCount);
+		_offsets.resize(frameCount);
 		_dataMapped.resize(frameCount);
 
-		for (uint16_t fIdx = 0; fIdx < frameCount; ++fIdx) {
-			_proc.createBuffer(size, bufferUsage, bufferSpaceToVkMemoryProperty(space), _buffers[fIdx], _memory[fIdx]);
-			// create mapped data memory
-			if (CPU_GPU == space) {
-				vkMapMemory(_proc._device, _memory[fIdx], 0u, size, 0u, &_dataMapped[fIdx]);
+		if (_packed) {
+			_frameStride = calculateFrameStride(size);
+			_memory.resize(1);
+
+			// one buffer holds every frame, frame n begins at n * _frameStride
+			_proc.createBuffer(_frameStride * frameCount, bufferUsage, bufferSpaceToVkMemoryProperty(space), _buffers[0], _memory[0]);
+
+			for (uint16_t fIdx = 0; fIdx < frameCount; ++fIdx) {
+				_buffers[fIdx] = _buffers[0];
+				_offsets[fIdx] = _frameStride * fIdx;
+				// host visible memory is persistently mapped by the memory allocator
+				_dataMapped[fIdx] = _memory[0].mapped ? (char*)_memory[0].mapped + _offsets[fIdx] : NULL;
+			}
+		}
+		else {
+			_frameStride = size;
+			_memory.resize(frameCount);
+
+			for (uint16_t fIdx = 0; fIdx < frameCount; ++fIdx) {
+				_proc.createBuffer(size, bufferUsage, bufferSpaceToVkMemoryProperty(space), _buffers[fIdx], _memory[fIdx]);
+				_offsets[fIdx] = 0u;
+				// host visible memory is persistently mapped by the memory allocator
+				_dataMapped[fIdx] = _memory[fIdx].mapped;
 			}
 		}
 	}
@@ -47,24 +68,13 @@ namespace val
 		__VAL_DEBUG_ValidateBufferCopy(_size, dataSize, srcOffset, dstOffset);
 #endif // !NDEBUG
 
-		// create staging buffer
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
-		_proc.createBuffer(dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-		void* stagingData;
-		vkMapMemory(_proc._device, stagingBufferMemory, 0, dataSize, 0, &stagingData);
-		memcpy(stagingData, data, (size_t)dataSize);
-		vkUnmapMemory(_proc._device, stagingBufferMemory);
-
-		_proc.copyBuffer(stagingBuffer, _buffers[frameIdx], (VkDeviceSize)dataSize, srcOffset, dstOffset);
-		// cleanup staging buffer
-		vkDestroyBuffer(_proc._device, stagingBuffer, VK_NULL_HANDLE);
-		vkFreeMemory(_proc._device, stagingBufferMemory, VK_NULL_HANDLE);
+		// the data is written into the staging ring of the VAL_PROC, the copy is submitted with the current frame
+		_proc.uploadToBuffers((char*)data + srcOffset, (VkDeviceSize)dataSize, &_buffers[frameIdx], 1u, _offsets[frameIdx] + dstOffset);
 	}
 
 	// overwrites from a staging buffer for all frames in flight
 	void buffer::overwriteFromStagingBuffer(void* data, uint64_t dataSize, VkDeviceSize srcOffset, VkDeviceSize dstOffset) {
-		overwriteFromStagingBuffer(data, dataSize, 0u, _buffers.size(), srcOffset, dstOffset);
+		overwriteFromStagingBuffer(data, dataSize, 0u, _frameCount, srcOffset, dstOffset);
 	}
 
 	// overwrites from a staging buffer for all frames within the specified range 
@@ -74,22 +84,17 @@ namespace val
 		__VAL_DEBUG_ValidateBufferCopy(_size, dataSize, srcOffset, dstOffset);
 #endif // !NDEBUG
 
-		// create staging buffer
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
-		_proc.createBuffer(dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-		void* stagingData;
-		vkMapMemory(_proc._device, stagingBufferMemory, 0, dataSize, 0, &stagingData);
-		memcpy(stagingData, data, (size_t)dataSize);
-		vkUnmapMemory(_proc._device, stagingBufferMemory);
-
-		for (uint8_t fIdx = frameIdxBegin; fIdx < frameRangeEnd; ++fIdx) {
-			_proc.copyBuffer(stagingBuffer, _buffers[fIdx], (VkDeviceSize)dataSize, srcOffset, dstOffset);
+		// the data is only written into the staging ring once, and then copied into each frame
+		if (_packed) {
+			std::vector<VkDeviceSize> dstOffsets(frameRangeEnd - frameIdxBegin);
+			for (uint16_t fIdx = frameIdxBegin; fIdx < frameRangeEnd; ++fIdx) {
+				dstOffsets[fIdx - frameIdxBegin] = _offsets[fIdx] + dstOffset;
+			}
+			_proc.uploadToBuffer((char*)data + srcOffset, (VkDeviceSize)dataSize, _buffers[0], dstOffsets.data(), dstOffsets.size());
+		}
+		else {
+			_proc.uploadToBuffers((char*)data + srcOffset, (VkDeviceSize)dataSize, &_buffers[frameIdxBegin], frameRangeEnd - frameIdxBegin, dstOffset);
 		}
-
-		// cleanup staging buffer
-		vkDestroyBuffer(_proc._device, stagingBuffer, VK_NULL_HANDLE);
-		vkFreeMemory(_proc._device, stagingBufferMemory, VK_NULL_HANDLE);
 	}
 
 
@@ -99,7 +104,8 @@ namespace val
 		__VAL_DEBUG_ValidateBufferCopy(_size, srcBufferRange, srcOffset, dstOffset);
 #endif // !NDEBUG
 
-		_proc.copyBuffer(_buffers[dstFrameIdx], srcBuffer._buffers[srcFrameIdx], srcBufferRange, srcOffset, dstOffset);
+		_proc.copyBuffer(srcBuffer._buffers[srcFrameIdx], _buffers[dstFrameIdx], srcBufferRange,
+			srcBuffer._offsets[srcFrameIdx] + srcOffset, _offsets[dstFrameIdx] + dstOffset);
 	}
 
 	// overwrites all buffers for every frame in flight;
@@ -112,52 +118,74 @@ namespace val
 		}
 #endif // !NDEBUG
 
-		for (uint32_t fIdx = 0; fIdx < _buffers.size(); ++fIdx) {
+		for (uint32_t fIdx = 0; fIdx < _frameCount; ++fIdx) {
 			overwriteFromBuffer(srcBuffer, srcBufferRange, fIdx, fIdx, srcOffset, dstOffset);
 		}
 	}
 
 	void buffer::resize(uint32_t newSize) {
 		// only resize if needed
-		if (newSize != _size) {
-			for (uint8_t fIdx = 0; fIdx < _buffers.size(); ++fIdx) {
+		if (newSize == _size) {
+			return;
+		}
+
+		if (_packed) {
+			const VkDeviceSize newStride = calculateFrameStride(newSize);
+			VkBuffer tmpBuffer;
+			memoryAllocation tmpMem;
+
+			// create new buffer and copy every frame of the old one into it, the copies are submitted together
+			_proc.createBuffer(newStride * _frameCount, _usage, bufferSpaceToVkMemoryProperty(_space), tmpBuffer, tmpMem);
+			{
+				uploadBatch batch(_proc);
+				for (uint32_t fIdx = 0; fIdx < _frameCount; ++fIdx) {
+					batch.copyBuffer(_buffers[0], tmpBuffer, std::min(_size, newSize), _offsets[fIdx], newStride * fIdx);
+				}
+				batch.submitAndWait();
+			}
+
+			// destroy the old buffer
+			_proc.destroyBuffer(_buffers[0], _memory[0]);
+
+			_memory[0] = tmpMem;
+			_frameStride = newStride;
+			for (uint32_t fIdx = 0; fIdx < _frameCount; ++fIdx) {
+				_buffers[fIdx] = tmpBuffer;
+				_offsets[fIdx] = newStride * fIdx;
+				_dataMapped[fIdx] = tmpMem.mapped ? (char*)tmpMem.mapped + _offsets[fIdx] : NULL;
+			}
+		}
+		else {
+			for (uint8_t fIdx = 0; fIdx < _frameCount; ++fIdx) {
 				VkBuffer tmpBuffer;
-				VkDeviceMemory tmpMem;
+				memoryAllocation tmpMem;
 
 				// create new buffer and copy the old one into it
 				_proc.createBuffer(newSize, _usage, bufferSpaceToVkMemoryProperty(_space), tmpBuffer, tmpMem);
-				_proc.copyBuffer(tmpBuffer, _buffers[fIdx], 0u, 0u);
+				_proc.copyBuffer(_buffers[fIdx], tmpBuffer, std::min(_size, newSize));
 
 				// destroy the old buffer
-				vkDestroyBuffer(_proc._device, tmpBuffer, VK_NULL_HANDLE);
-				vkFreeMemory(_proc._device, _memory[fIdx], VK_NULL_HANDLE);
-
-				// remap memory needed
-				if (CPU_GPU == _space) {
-					vkUnmapMemory(_proc._device, _memory[fIdx]);
-					vkMapMemory(_proc._device, tmpMem, 0u, _size, 0u, &_dataMapped[fIdx]);
-				}
+				_proc.destroyBuffer(_buffers[fIdx], _memory[fIdx]);
 
 				_buffers[fIdx] = tmpBuffer;
 				_memory[fIdx] = tmpMem;
-				_size = newSize;
+				_dataMapped[fIdx] = tmpMem.mapped;
 			}
+			_frameStride = newSize;
 		}
+		_size = newSize;
 	}
 
 	void buffer::destroy() {
 		_dataMapped.clear();
-		for (uint8_t fIdx = 0; fIdx < _buffers.size(); ++fIdx) {
-			
-			if (_memory[fIdx]) {
-				vkFreeMemory(_proc._device, _memory[fIdx], VK_NULL_HANDLE);
-			}
-			if (_buffers[fIdx]) {
-				vkDestroyBuffer(_proc._device, _buffers[fIdx], VK_NULL_HANDLE);
-			}
+		// a packed buffer only owns the handle of it's first frame
+		for (uint8_t i = 0; i < _memory.size(); ++i) {
+			_proc.destroyBuffer(_buffers[i], _memory[i]);
 		}
 		_buffers.clear();
+		_offsets.clear();
 		_memory.clear();
+		_frameCount = 0u;
 	}
 
 	const bufferSpace& buffer::getBufferSpace() const  {
@@ -165,7 +193,7 @@ namespace val
 	}
 
 	const uint32_t& buffer::getFrameCount() const {
-		return _buffers.size();
+		return _frameCount;
 	}
 
 	const uint32_t& buffer::size() const {
@@ -176,8 +204,24 @@ namespace val
 		return _buffers[frameIdx];
 	}
 
+	VkDeviceSize buffer::getOffset(const uint8_t frameIdx) const {
+		return _offsets[frameIdx];
+	}
+
+	VkDeviceSize buffer::getFrameStride() const {
+		return _frameStride;
+	}
+
+	bool buffer::isPacked() const {
+		return _packed;
+	}
+
 	const VkDeviceMemory& buffer::getDeviceMemory(const uint8_t frameIdx) {
-		return _memory[frameIdx];
+		return _memory[allocationIdx(frameIdx)].memory;
+	}
+
+	const memoryAllocation& buffer::getMemoryAllocation(const uint8_t frameIdx) {
+		return _memory[allocationIdx(frameIdx)];
 	}
 
 	void* buffer::getDataMapped(const uint8_t frameIdx) {
@@ -194,26 +238,42 @@ namespace val
 
 	////////////////////////////////////////////////////////////////////////////
 	void buffer::copy(const buffer& other) {
-		const uint32_t frameCount = other._buffers.size();
 		// cleanup old data.
 		this->destroy();
 
-		_size = other._size;
-		_space = other._space;
-		_proc = other._proc;
-
-		_buffers.resize(frameCount);
-		_memory.resize(frameCount);
-		_dataMapped.resize(frameCount);
+		create(other._proc, other._size, other._space, other._usage, other._frameCount, other._packed);
 
-		
-		for (uint16_t fIdx = 0; fIdx < frameCount; ++fIdx) {
-			_proc.createBuffer(other._size, other._usage, bufferSpaceToVkMemoryProperty(_space), _buffers[fIdx], _memory[fIdx]);
-			// create mapped data memory
-			if (CPU_GPU == _space) {
-				vkMapMemory(_proc._device, _memory[fIdx], 0u, _size, 0u, &_dataMapped[fIdx]);
+		if (_packed) {
+			// the strides are equal, so all the frames can be copied at once
+			_proc.copyBuffer(other._buffers[0], _buffers[0], _frameStride * _frameCount);
+		}
+		else {
+			for (uint32_t fIdx = 0; fIdx < _frameCount; ++fIdx) {
+				_proc.copyBuffer(other._buffers[fIdx], _buffers[fIdx], _size);
 			}
-			_proc.copyBuffer(other._buffers[fIdx], _buffers[fIdx], _size);
 		}
 	}
-}
\ No newline at end of file
+
+	VkDeviceSize buffer::calculateFrameStride(const uint32_t size) const {
+		const VkPhysicalDeviceLimits& limits = _proc._physicalDeviceProperties.limits;
+
+		// index buffers require an offset that is a multiple of the index size
+		VkDeviceSize alignment = 4u;
+		if (_usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+			alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+		}
+		if (_usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+			alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+		}
+		if (_usage & (VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT)) {
+			alignment = std::max(alignment, limits.minTexelBufferOffsetAlignment);
+		}
+		if (_space == CPU_GPU) {
+			// host visible memory may not be coherent, frames must not share an atom so that they can be flushed independently
+			alignment = std::max(alignment, limits.nonCoherentAtomSize);
+		}
+
+		// all of the limits are powers of 2
+		return (VkDeviceSize(size) + alignment - 1) & ~(alignment - 1);
+	}
+}
@@ -18,8 +18,20 @@ namespace val {
 
 		// bind pipeline and respective descriptor sets
 		vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, proc._computePipelines[computePipeline.pipelineIdx]);
+		if (computePipeline.useDescriptorBuffer) {
+			proc._descriptorBuffer.bind(cmdBuffer);
+			proc._descriptorBuffer.setOffset(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, proc._computePipelineLayouts[computePipeline.pipelineIdx],
+				proc._descriptorBufferOffsets[computePipeline.descriptorsIdx][currentFrame]);
+			return;
+		}
+		VkDescriptorSet descriptorSets[(uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT];
+		const uint32_t descriptorSetCount = proc.getDescriptorSetsToBind(computePipeline, currentFrame, descriptorSets);
 		vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, proc._computePipelineLayouts[computePipeline.pipelineIdx],
-			0, 1, &proc._descriptorSets[computePipeline.descriptorsIdx][currentFrame], 0, nullptr);
+			0, descriptorSetCount, descriptorSets, computePipeline.defaultDynamicOffsets.size(), computePipeline.defaultDynamicOffsets.data());
+
+		if (computePipeline.bindlessSetNo != UINT32_MAX) {
+			proc._bindless.bind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, proc._computePipelineLayouts[computePipeline.pipelineIdx], computePipeline.bindlessSetNo);
+		}
 	}
 
 	void computeTarget::begin(VAL_PROC& proc)
@@ -32,6 +44,8 @@ namespace val {
 		vkResetFences(proc._device, 1, &queue._fences[proc._currentFrame]);
 		vkResetCommandBuffer(queue._commandBuffers[proc._currentFrame], /*VkCommandBufferResetFlagBits*/ 0);
 
+		// descriptor sets can't be updated once they're bound by the command buffer
+		proc.flushDescriptorWrites();
 
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -48,6 +62,13 @@ namespace val {
 
 		auto& currentFrame = proc._currentFrame;
 		auto& queue = proc._computeQueue;
+
+		// the uploads of this frame are submitted ahead of the dispatches, the staging ring submits on the graphics queue.
+		// A compute queue of another family isn't ordered after it, so the uploads are waited for on the host
+		proc.flushStagingUploads();
+		if (queue._queue != proc._graphicsQueue._queue) {
+			proc._stagingRing.waitIdle();
+		}
 		
 		// SUBMIT
 		VkPipelineStageFlags* waitStages = (VkPipelineStageFlags*)calloc(waitSemaphores.size(), sizeof(VkPipelineStageFlags));
@@ -0,0 +1,196 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/descriptorAllocator.hpp>
+#include <VAL/lib/debugReporting/debugCallbacks.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace val {
+
+	descriptorAllocator::descriptorAllocator(descriptorAllocator&& other) noexcept {
+		_device = other._device;
+		_flags = other._flags;
+		_setsPerPool = other._setsPerPool;
+		_ratios = std::move(other._ratios);
+		_readyPools = std::move(other._readyPools);
+		_fullPools = std::move(other._fullPools);
+		other._device = VK_NULL_HANDLE;
+	}
+
+	const std::vector<descriptorAllocator::poolSizeRatio>& descriptorAllocator::getDefaultRatios() {
+		// every descriptor type that VAL creates sets for
+		static const std::vector<poolSizeRatio> ratios = {
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.f },
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.f },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 0.5f },
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.f },
+			{ VK_DESCRIPTOR_TYPE_SAMPLER, 1.f },
+			{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2.f },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 0.5f },
+			{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f }
+		};
+		return ratios;
+	}
+
+	void descriptorAllocator::create(VkDevice device, const bool freeable /*DEFAULT = false*/, const uint32_t setsPerPool /*DEFAULT = VAL_DESCRIPTOR_ALLOCATOR_SETS_PER_POOL*/,
+		const std::vector<poolSizeRatio>& ratios /*DEFAULT = getDefaultRatios()*/)
+	{
+		_device = device;
+		_flags = freeable ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0u;
+		_setsPerPool = setsPerPool;
+		_ratios = ratios;
+	}
+
+	void descriptorAllocator::destroy() {
+		if (!_device) {
+			return;
+		}
+
+		for (VkDescriptorPool pool : _readyPools) {
+			vkDestroyDescriptorPool(_device, pool, NULL);
+		}
+		_readyPools.clear();
+
+		for (VkDescriptorPool pool : _fullPools) {
+			vkDestroyDescriptorPool(_device, pool, NULL);
+		}
+		_fullPools.clear();
+
+		_device = VK_NULL_HANDLE;
+	}
+
+	VkDescriptorPool descriptorAllocator::allocate(const VkDescriptorSetLayout* layouts, const uint32_t setCount, VkDescriptorSet* setsOut,
+		const std::vector<VkDescriptorPoolSize>& requiredSizes /*DEFAULT = {}*/, const void* pNext /*DEFAULT = NULL*/)
+	{
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.pNext = pNext;
+		allocInfo.descriptorPool = getPool(requiredSizes);
+		allocInfo.descriptorSetCount = setCount;
+		allocInfo.pSetLayouts = layouts;
+
+		VkResult result = vkAllocateDescriptorSets(_device, &allocInfo, setsOut);
+		if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+			// the pool is exhausted, it's only allocated from again after it has been freed or reset
+			_fullPools.push_back(allocInfo.descriptorPool);
+			_readyPools.pop_back();
+
+			allocInfo.descriptorPool = createPool(_setsPerPool > setCount ? _setsPerPool : setCount, requiredSizes);
+			_readyPools.push_back(allocInfo.descriptorPool);
+
+			result = vkAllocateDescriptorSets(_device, &allocInfo, setsOut);
+		}
+
+		if (result != VK_SUCCESS) {
+			dbg::printError("VAL: Failed to allocate %d descriptor sets, error code: %d\n", setCount, result);
+			throw std::runtime_error("VAL: FAILED TO ALLOCATE DESCRIPTOR SETS!");
+		}
+
+		return allocInfo.descriptorPool;
+	}
+
+	VkDescriptorSet descriptorAllocator::allocate(VkDescriptorSetLayout layout, const std::vector<VkDescriptorPoolSize>& requiredSizes /*DEFAULT = {}*/) {
+		VkDescriptorSet set;
+		allocate(&layout, 1u, &set, requiredSizes);
+		return set;
+	}
+
+	void descriptorAllocator::free(VkDescriptorPool pool, const VkDescriptorSet* sets, const uint32_t setCount) {
+#ifndef NDEBUG
+		if (!(_flags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)) {
+			dbg::printError("VAL: Descriptor sets can only be freed individually by a descriptor allocator that was created as freeable!\n");
+			return;
+		}
+#endif // !NDEBUG
+
+		vkFreeDescriptorSets(_device, pool, setCount, sets);
+
+		// the pool has space again
+		auto it = std::find(_fullPools.begin(), _fullPools.end(), pool);
+		if (it != _fullPools.end()) {
+			_fullPools.erase(it);
+			_readyPools.insert(_readyPools.begin(), pool);
+		}
+	}
+
+	void descriptorAllocator::reset() {
+		for (VkDescriptorPool pool : _readyPools) {
+			vkResetDescriptorPool(_device, pool, 0);
+		}
+		for (VkDescriptorPool pool : _fullPools) {
+			vkResetDescriptorPool(_device, pool, 0);
+			_readyPools.push_back(pool);
+		}
+		_fullPools.clear();
+	}
+
+	VkDescriptorPool descriptorAllocator::getPool(const std::vector<VkDescriptorPoolSize>& requiredSizes) {
+		if (_readyPools.empty()) {
+			_readyPools.push_back(createPool(_setsPerPool, requiredSizes));
+		}
+		return _readyPools.back();
+	}
+
+	VkDescriptorPool descriptorAllocator::createPool(const uint32_t setCount, const std::vector<VkDescriptorPoolSize>& requiredSizes) {
+		std::vector<VkDescriptorPoolSize> poolSizes;
+		poolSizes.reserve(_ratios.size() + requiredSizes.size());
+		for (const poolSizeRatio& ratio : _ratios) {
+			const uint32_t count = uint32_t(ratio.ratio * setCount);
+			poolSizes.push_back({ ratio.type, count > 0u ? count : 1u });
+		}
+		// the required sizes may list a type more than once
+		std::vector<VkDescriptorPoolSize> requiredTotals;
+		for (const VkDescriptorPoolSize& required : requiredSizes) {
+			auto it = std::find_if(requiredTotals.begin(), requiredTotals.end(), [&](const VkDescriptorPoolSize& size) { return size.type == required.type; });
+			if (it == requiredTotals.end()) {
+				requiredTotals.push_back(required);
+			}
+			else {
+				it->descriptorCount += required.descriptorCount;
+			}
+		}
+		for (const VkDescriptorPoolSize& required : requiredTotals) {
+			auto it = std::find_if(poolSizes.begin(), poolSizes.end(), [&](const VkDescriptorPoolSize& size) { return size.type == required.type; });
+			if (it == poolSizes.end()) {
+				poolSizes.push_back(required);
+			}
+			else if (it->descriptorCount < required.descriptorCount) {
+				it->descriptorCount = required.descriptorCount;
+			}
+		}
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = _flags;
+		poolInfo.maxSets = setCount;
+		poolInfo.poolSizeCount = (uint32_t)poolSizes.size();
+		poolInfo.pPoolSizes = poolSizes.data();
+
+		VkDescriptorPool pool;
+		if (vkCreateDescriptorPool(_device, &poolInfo, NULL, &pool) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: FAILED TO CREATE DESCRIPTOR POOL!");
+		}
+
+		// the next pool is larger, so that the number of pools grows slowly
+		_setsPerPool = std::min(_setsPerPool + _setsPerPool / 2u, (uint32_t)VAL_DESCRIPTOR_ALLOCATOR_MAX_SETS_PER_POOL);
+
+		return pool;
+	}
+}
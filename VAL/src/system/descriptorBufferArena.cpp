@@ -0,0 +1,364 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <VAL/lib/system/descriptorBufferArena.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+#include <stdexcept>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+
+namespace val {
+
+	void descriptorBufferArena::create(VAL_PROC& proc, const uint8_t frameCount, const VkDeviceSize persistentSize /*DEFAULT = VAL_DESCRIPTOR_BUFFER_PERSISTENT_SIZE*/,
+		const VkDeviceSize frameSize /*DEFAULT = VAL_DESCRIPTOR_BUFFER_FRAME_SIZE*/)
+	{
+		_proc = &proc;
+		VkDevice device = _proc->_device;
+
+		_vkGetDescriptorSetLayoutSizeEXT = (PFN_vkGetDescriptorSetLayoutSizeEXT)vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutSizeEXT");
+		_vkGetDescriptorSetLayoutBindingOffsetEXT = (PFN_vkGetDescriptorSetLayoutBindingOffsetEXT)vkGetDeviceProcAddr(device, "vkGetDescriptorSetLayoutBindingOffsetEXT");
+		_vkGetDescriptorEXT = (PFN_vkGetDescriptorEXT)vkGetDeviceProcAddr(device, "vkGetDescriptorEXT");
+		_vkCmdBindDescriptorBuffersEXT = (PFN_vkCmdBindDescriptorBuffersEXT)vkGetDeviceProcAddr(device, "vkCmdBindDescriptorBuffersEXT");
+		_vkCmdSetDescriptorBufferOffsetsEXT = (PFN_vkCmdSetDescriptorBufferOffsetsEXT)vkGetDeviceProcAddr(device, "vkCmdSetDescriptorBufferOffsetsEXT");
+
+		_properties = {};
+		_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2 properties{};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties.pNext = &_properties;
+		vkGetPhysicalDeviceProperties2(_proc->_physicalDevice, &properties);
+
+		// every set starts at a multiple of the offset alignment, so the regions are rounded up to it too
+		const VkDeviceSize alignment = _properties.descriptorBufferOffsetAlignment;
+		_persistentSize = (persistentSize + alignment - 1) & ~(alignment - 1);
+		_frameSize = (frameSize + alignment - 1) & ~(alignment - 1);
+		_frameCount = frameCount;
+		_frameIdx = 0u;
+		_frameHead = 0u;
+
+		// samplers and resources share the buffer, it only counts once against maxResourceDescriptorBufferBindings and maxSamplerDescriptorBufferBindings
+		_proc->createBuffer(_persistentSize + _frameSize * frameCount,
+			VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _buffer, _memory);
+
+		VkBufferDeviceAddressInfo addressInfo{};
+		addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+		addressInfo.buffer = _buffer;
+		_address = vkGetBufferDeviceAddress(device, &addressInfo);
+
+		_freeRanges.clear();
+		_freeRanges[0u] = _persistentSize;
+		_allocatedSets.clear();
+		_pendingWrites.clear();
+		_pendingWrites.resize(_proc->_MAX_FRAMES_IN_FLIGHT);
+	}
+
+	void descriptorBufferArena::destroy() {
+		if (!isCreated()) {
+			return;
+		}
+
+		_proc->destroyBuffer(_buffer, _memory);
+		_address = 0u;
+		_freeRanges.clear();
+		_allocatedSets.clear();
+		_setSizes.clear();
+		_bindingOffsets.clear();
+		_pendingWrites.clear();
+		_proc = NULL;
+	}
+
+	VkDeviceSize descriptorBufferArena::allocate(VkDescriptorSetLayout layout) {
+		const VkDeviceSize size = getSetSize(layout);
+
+		// first fit, the sets of most pipelines are only a few hundred bytes
+		for (auto it = _freeRanges.begin(); it != _freeRanges.end(); ++it) {
+			if (it->second < size) {
+				continue;
+			}
+
+			const VkDeviceSize offset = it->first;
+			const VkDeviceSize remaining = it->second - size;
+			_freeRanges.erase(it);
+			if (remaining > 0u) {
+				_freeRanges[offset + size] = remaining;
+			}
+
+			_allocatedSets[offset] = size;
+			return offset;
+		}
+
+		dbg::printError("VAL: The persistent region of the descriptor buffer is full, a set of %llu bytes can't be allocated. Increase VAL_DESCRIPTOR_BUFFER_PERSISTENT_SIZE.\n",
+			(unsigned long long)size);
+		throw std::runtime_error("VAL: THE DESCRIPTOR BUFFER IS FULL!");
+	}
+
+	void descriptorBufferArena::free(const VkDeviceSize setOffset) {
+		const auto allocated = _allocatedSets.find(setOffset);
+		if (allocated == _allocatedSets.end()) {
+#ifndef NDEBUG
+			dbg::printWarning("VAL: No descriptor buffer set has been allocated at offset %llu\n", (unsigned long long)setOffset);
+#endif // !NDEBUG
+			return;
+		}
+
+		VkDeviceSize offset = setOffset;
+		VkDeviceSize size = allocated->second;
+		_allocatedSets.erase(allocated);
+
+		// merge with the free ranges on either side
+		auto next = _freeRanges.lower_bound(offset);
+		if (next != _freeRanges.end() && offset + size == next->first) {
+			size += next->second;
+			next = _freeRanges.erase(next);
+		}
+		if (next != _freeRanges.begin()) {
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == offset) {
+				offset = prev->first;
+				size += prev->second;
+				_freeRanges.erase(prev);
+			}
+		}
+		_freeRanges[offset] = size;
+	}
+
+	VkDeviceSize descriptorBufferArena::allocateTransient(VkDescriptorSetLayout layout, const VkDeviceSize srcSetOffset) {
+		const VkDeviceSize size = getSetSize(layout);
+
+		if (_frameHead + size > _frameSize) {
+			dbg::printError("VAL: The frame region of the descriptor buffer is full, a set of %llu bytes can't be allocated. Increase VAL_DESCRIPTOR_BUFFER_FRAME_SIZE.\n",
+				(unsigned long long)size);
+			throw std::runtime_error("VAL: THE DESCRIPTOR BUFFER FRAME REGION IS FULL!");
+		}
+
+		const VkDeviceSize offset = _persistentSize + VkDeviceSize(_frameIdx) * _frameSize + _frameHead;
+		_frameHead += size;
+
+		memcpy((char*)_memory.mapped + offset, (const char*)_memory.mapped + srcSetOffset, (size_t)size);
+		return offset;
+	}
+
+	void descriptorBufferArena::nextFrame() {
+		if (!isCreated()) {
+			return;
+		}
+
+		_frameIdx = (_frameIdx + 1u) % _frameCount;
+		_frameHead = 0u;
+	}
+
+	void descriptorBufferArena::writeBuffer(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+		const VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo)
+	{
+#ifndef NDEBUG
+		if (bufferInfo.range == VK_WHOLE_SIZE) {
+			dbg::printError("VAL: Descriptor buffer binding %u is written with a range of VK_WHOLE_SIZE, the size of the range must be given!\n", binding);
+			throw std::runtime_error("VAL: DESCRIPTOR BUFFER DESCRIPTORS CAN'T HAVE A RANGE OF VK_WHOLE_SIZE!");
+		}
+#endif // !NDEBUG
+
+		VkBufferDeviceAddressInfo addressInfo{};
+		addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+		addressInfo.buffer = bufferInfo.buffer;
+
+		VkDescriptorAddressInfoEXT descriptorAddress{};
+		descriptorAddress.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+		descriptorAddress.address = vkGetBufferDeviceAddress(_proc->_device, &addressInfo) + bufferInfo.offset;
+		descriptorAddress.range = bufferInfo.range;
+		descriptorAddress.format = VK_FORMAT_UNDEFINED;
+
+		VkDescriptorGetInfoEXT getInfo{};
+		getInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+		getInfo.type = type;
+		if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+			getInfo.data.pUniformBuffer = &descriptorAddress;
+		}
+		else {
+			getInfo.data.pStorageBuffer = &descriptorAddress;
+		}
+
+		_vkGetDescriptorEXT(_proc->_device, &getInfo, getDescriptorSize(type), getDescriptorPtr(layout, setOffset, binding, arrayElement, type));
+	}
+
+	void descriptorBufferArena::writeImage(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+		const VkDescriptorType type, const VkDescriptorImageInfo& imageInfo)
+	{
+		VkDescriptorGetInfoEXT getInfo{};
+		getInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+		getInfo.type = type;
+		switch (type) {
+		case VK_DESCRIPTOR_TYPE_SAMPLER:
+			getInfo.data.pSampler = &imageInfo.sampler;
+			break;
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			getInfo.data.pCombinedImageSampler = &imageInfo;
+			break;
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			getInfo.data.pStorageImage = &imageInfo;
+			break;
+		case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+			getInfo.data.pInputAttachmentImage = &imageInfo;
+			break;
+		default:
+			getInfo.data.pSampledImage = &imageInfo;
+			break;
+		}
+
+		_vkGetDescriptorEXT(_proc->_device, &getInfo, getDescriptorSize(type), getDescriptorPtr(layout, setOffset, binding, arrayElement, type));
+	}
+
+	void descriptorBufferArena::write(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const VkWriteDescriptorSet& write) {
+		for (uint32_t i = 0; i < write.descriptorCount; ++i) {
+			if (write.pBufferInfo) {
+				writeBuffer(layout, setOffset, write.dstBinding, write.dstArrayElement + i, write.descriptorType, write.pBufferInfo[i]);
+			}
+			else if (write.pImageInfo) {
+				writeImage(layout, setOffset, write.dstBinding, write.dstArrayElement + i, write.descriptorType, write.pImageInfo[i]);
+			}
+		}
+	}
+
+	void descriptorBufferArena::queueBuffer(const uint8_t frameIdx, VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding,
+		const uint32_t arrayElement, const VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo)
+	{
+		pendingWrite& write = _pendingWrites[frameIdx].emplace_back();
+		write.layout = layout;
+		write.setOffset = setOffset;
+		write.binding = binding;
+		write.arrayElement = arrayElement;
+		write.type = type;
+		write.isImage = false;
+		write.bufferInfo = bufferInfo;
+	}
+
+	void descriptorBufferArena::queueImage(const uint8_t frameIdx, VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding,
+		const uint32_t arrayElement, const VkDescriptorType type, const VkDescriptorImageInfo& imageInfo)
+	{
+		pendingWrite& write = _pendingWrites[frameIdx].emplace_back();
+		write.layout = layout;
+		write.setOffset = setOffset;
+		write.binding = binding;
+		write.arrayElement = arrayElement;
+		write.type = type;
+		write.isImage = true;
+		write.imageInfo = imageInfo;
+	}
+
+	void descriptorBufferArena::flush(const uint8_t frameIdx) {
+		if (!isCreated()) {
+			return;
+		}
+
+		// a later write to the same descriptor simply overwrites the earlier one
+		for (const pendingWrite& write : _pendingWrites[frameIdx]) {
+			if (write.isImage) {
+				writeImage(write.layout, write.setOffset, write.binding, write.arrayElement, write.type, write.imageInfo);
+			}
+			else {
+				writeBuffer(write.layout, write.setOffset, write.binding, write.arrayElement, write.type, write.bufferInfo);
+			}
+		}
+		_pendingWrites[frameIdx].clear();
+	}
+
+	void descriptorBufferArena::discard(const VkDeviceSize setOffset) {
+		for (std::vector<pendingWrite>& frameWrites : _pendingWrites) {
+			frameWrites.erase(std::remove_if(frameWrites.begin(), frameWrites.end(),
+				[&](const pendingWrite& write) { return write.setOffset == setOffset; }), frameWrites.end());
+		}
+	}
+
+	void descriptorBufferArena::bind(VkCommandBuffer cmdBuffer) const {
+		VkDescriptorBufferBindingInfoEXT bindingInfo{};
+		bindingInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+		bindingInfo.address = _address;
+		bindingInfo.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+
+		_vkCmdBindDescriptorBuffersEXT(cmdBuffer, 1u, &bindingInfo);
+	}
+
+	void descriptorBufferArena::setOffset(VkCommandBuffer cmdBuffer, const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const VkDeviceSize setOffset) const {
+		const uint32_t bufferIdx = 0u;
+		_vkCmdSetDescriptorBufferOffsetsEXT(cmdBuffer, bindPoint, pipelineLayout, 0u, 1u, &bufferIdx, &setOffset);
+	}
+
+	VkDeviceSize descriptorBufferArena::getSetSize(VkDescriptorSetLayout layout) {
+		const auto it = _setSizes.find(layout);
+		if (it != _setSizes.end()) {
+			return it->second;
+		}
+
+		VkDeviceSize size = 0u;
+		_vkGetDescriptorSetLayoutSizeEXT(_proc->_device, layout, &size);
+
+		const VkDeviceSize alignment = _properties.descriptorBufferOffsetAlignment;
+		size = (size + alignment - 1) & ~(alignment - 1);
+		// a set without bindings still needs a distinct offset
+		if (size == 0u) {
+			size = alignment;
+		}
+
+		_setSizes[layout] = size;
+		return size;
+	}
+
+	VkDeviceSize descriptorBufferArena::getBindingOffset(VkDescriptorSetLayout layout, const uint32_t binding) {
+		const std::pair<VkDescriptorSetLayout, uint32_t> key = { layout, binding };
+		const auto it = _bindingOffsets.find(key);
+		if (it != _bindingOffsets.end()) {
+			return it->second;
+		}
+
+		VkDeviceSize offset = 0u;
+		_vkGetDescriptorSetLayoutBindingOffsetEXT(_proc->_device, layout, binding, &offset);
+		_bindingOffsets[key] = offset;
+		return offset;
+	}
+
+	size_t descriptorBufferArena::getDescriptorSize(const VkDescriptorType type) const {
+		switch (type) {
+		case VK_DESCRIPTOR_TYPE_SAMPLER:
+			return _properties.samplerDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			return _properties.combinedImageSamplerDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			return _properties.sampledImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			return _properties.storageImageDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			return _properties.uniformBufferDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			return _properties.storageBufferDescriptorSize;
+		case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+			return _properties.inputAttachmentDescriptorSize;
+		default:
+			dbg::printError("VAL: Descriptor type %d can't be written into a descriptor buffer!\n", (int)type);
+			throw std::runtime_error("VAL: UNSUPPORTED DESCRIPTOR BUFFER DESCRIPTOR TYPE!");
+		}
+	}
+
+	char* descriptorBufferArena::getDescriptorPtr(VkDescriptorSetLayout layout, const VkDeviceSize setOffset, const uint32_t binding, const uint32_t arrayElement,
+		const VkDescriptorType type)
+	{
+		return (char*)_memory.mapped + setOffset + getBindingOffset(layout, binding) + VkDeviceSize(arrayElement) * getDescriptorSize(type);
+	}
+}
@@ -0,0 +1,181 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/descriptorUpdateTemplate.hpp>
+#include <VAL/lib/debugReporting/debugCallbacks.hpp>
+
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+namespace val {
+
+	descriptorUpdateTemplate::descriptorUpdateTemplate(descriptorUpdateTemplate&& other) noexcept
+		: _device(other._device), _template(other._template), _entries(std::move(other._entries)), _dataSize(other._dataSize)
+	{
+		other._device = VK_NULL_HANDLE;
+		other._template = VK_NULL_HANDLE;
+		other._dataSize = 0u;
+	}
+
+	void descriptorUpdateTemplate::create(VkDevice device, VkDescriptorSetLayout setLayout, const VkDescriptorSetLayoutBinding* bindings, const uint32_t bindingCount) {
+		std::vector<VkDescriptorUpdateTemplateEntry> entries;
+		if (!buildEntries(bindings, bindingCount, entries)) {
+			return;
+		}
+
+		VkDescriptorUpdateTemplateCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+		createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+		createInfo.descriptorSetLayout = setLayout;
+
+		createTemplate(device, createInfo, entries);
+	}
+
+	void descriptorUpdateTemplate::createForPushDescriptors(VkDevice device, const VkDescriptorSetLayoutBinding* bindings, const uint32_t bindingCount,
+		const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const uint32_t set)
+	{
+		std::vector<VkDescriptorUpdateTemplateEntry> entries;
+		if (!buildEntries(bindings, bindingCount, entries)) {
+			return;
+		}
+
+		VkDescriptorUpdateTemplateCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+		createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR;
+		createInfo.pipelineBindPoint = bindPoint;
+		createInfo.pipelineLayout = pipelineLayout;
+		createInfo.set = set;
+
+		createTemplate(device, createInfo, entries);
+	}
+
+	void descriptorUpdateTemplate::destroy() {
+		if (_template != VK_NULL_HANDLE) {
+			vkDestroyDescriptorUpdateTemplate(_device, _template, NULL);
+			_template = VK_NULL_HANDLE;
+		}
+		_device = VK_NULL_HANDLE;
+		_entries.clear();
+		_dataSize = 0u;
+	}
+
+	size_t descriptorUpdateTemplate::getOffset(const uint32_t binding, const uint32_t arrayElement /*DEFAULT = 0u*/) const {
+		auto it = std::lower_bound(_entries.begin(), _entries.end(), binding,
+			[](const templateEntry& entry, const uint32_t binding) { return entry.binding < binding; });
+
+		if (it == _entries.end() || it->binding != binding || arrayElement >= it->descriptorCount) {
+			return SIZE_MAX;
+		}
+		return it->offset + (it->stride * arrayElement);
+	}
+
+	void descriptorUpdateTemplate::writeBuffer(void* data, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorBufferInfo& bufferInfo) const {
+		const size_t offset = getOffset(binding, arrayElement);
+#ifndef NDEBUG
+		if (offset == SIZE_MAX) {
+			dbg::printError("VAL: Binding %u, array element %u is not part of the descriptor update template!\n", binding, arrayElement);
+			return;
+		}
+#endif // !NDEBUG
+		memcpy((char*)data + offset, &bufferInfo, sizeof(VkDescriptorBufferInfo));
+	}
+
+	void descriptorUpdateTemplate::writeImage(void* data, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorImageInfo& imageInfo) const {
+		const size_t offset = getOffset(binding, arrayElement);
+#ifndef NDEBUG
+		if (offset == SIZE_MAX) {
+			dbg::printError("VAL: Binding %u, array element %u is not part of the descriptor update template!\n", binding, arrayElement);
+			return;
+		}
+#endif // !NDEBUG
+		memcpy((char*)data + offset, &imageInfo, sizeof(VkDescriptorImageInfo));
+	}
+
+	bool descriptorUpdateTemplate::buildEntries(const VkDescriptorSetLayoutBinding* bindings, const uint32_t bindingCount, std::vector<VkDescriptorUpdateTemplateEntry>& entriesOut) {
+		destroy();
+
+		std::vector<VkDescriptorSetLayoutBinding> sortedBindings(bindings, bindings + bindingCount);
+		std::sort(sortedBindings.begin(), sortedBindings.end(),
+			[](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) { return a.binding < b.binding; });
+
+		entriesOut.clear();
+		entriesOut.reserve(sortedBindings.size());
+		_entries.reserve(sortedBindings.size());
+
+		for (const VkDescriptorSetLayoutBinding& binding : sortedBindings) {
+			if (binding.descriptorCount == 0u) {
+				continue;
+			}
+
+			size_t stride = 0u;
+			switch (binding.descriptorType) {
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+			case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+			case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+				stride = sizeof(VkDescriptorBufferInfo);
+				break;
+			case VK_DESCRIPTOR_TYPE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+			case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+			case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+			case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+				stride = sizeof(VkDescriptorImageInfo);
+				break;
+			case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+			case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+				stride = sizeof(VkBufferView);
+				break;
+			default:
+				dbg::printWarning("VAL: Binding %u has a descriptor type (%d) that descriptor update templates don't support, it is left out of the template\n",
+					binding.binding, (int)binding.descriptorType);
+				continue;
+			}
+
+			templateEntry entry;
+			entry.binding = binding.binding;
+			entry.descriptorCount = binding.descriptorCount;
+			entry.offset = _dataSize;
+			entry.stride = stride;
+			_entries.push_back(entry);
+
+			VkDescriptorUpdateTemplateEntry vkEntry{};
+			vkEntry.dstBinding = binding.binding;
+			vkEntry.dstArrayElement = 0u;
+			vkEntry.descriptorCount = binding.descriptorCount;
+			vkEntry.descriptorType = binding.descriptorType;
+			vkEntry.offset = entry.offset;
+			vkEntry.stride = entry.stride;
+			entriesOut.push_back(vkEntry);
+
+			_dataSize += stride * binding.descriptorCount;
+		}
+
+		return !entriesOut.empty();
+	}
+
+	void descriptorUpdateTemplate::createTemplate(VkDevice device, VkDescriptorUpdateTemplateCreateInfo& createInfo, std::vector<VkDescriptorUpdateTemplateEntry>& entries) {
+		createInfo.descriptorUpdateEntryCount = (uint32_t)entries.size();
+		createInfo.pDescriptorUpdateEntries = entries.data();
+
+		if (vkCreateDescriptorUpdateTemplate(device, &createInfo, NULL, &_template) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to create descriptor update template!");
+		}
+		_device = device;
+	}
+}
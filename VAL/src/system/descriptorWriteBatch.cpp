@@ -0,0 +1,130 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/descriptorWriteBatch.hpp>
+
+#include <functional>
+
+namespace val {
+
+	size_t descriptorWriteBatch::writeKeyHasher::operator()(const writeKey& key) const {
+		size_t seed = std::hash<VkDescriptorSet>{}(key.set);
+		seed ^= std::hash<uint32_t>{}(key.binding) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= std::hash<uint32_t>{}(key.arrayElement) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		return seed;
+	}
+
+	void descriptorWriteBatch::writeBuffer(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo) {
+		pendingWrite& write = getWrite(set, binding, arrayElement);
+		write.type = type;
+		write.isImage = false;
+		write.bufferInfo = bufferInfo;
+	}
+
+	void descriptorWriteBatch::writeImage(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement, const VkDescriptorType type, const VkDescriptorImageInfo& imageInfo) {
+		pendingWrite& write = getWrite(set, binding, arrayElement);
+		write.type = type;
+		write.isImage = true;
+		write.imageInfo = imageInfo;
+	}
+
+	void descriptorWriteBatch::flush(VkDevice device) {
+		if (_writes.empty()) {
+			return;
+		}
+
+		std::vector<VkWriteDescriptorSet> descriptorWrites(_writes.size());
+		for (size_t i = 0; i < _writes.size(); ++i) {
+			const pendingWrite& write = _writes[i];
+
+			VkWriteDescriptorSet& descriptorWrite = descriptorWrites[i];
+			descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrite.dstSet = write.key.set;
+			descriptorWrite.dstBinding = write.key.binding;
+			descriptorWrite.dstArrayElement = write.key.arrayElement;
+			descriptorWrite.descriptorType = write.type;
+			descriptorWrite.descriptorCount = 1;
+			if (write.isImage) {
+				descriptorWrite.pImageInfo = &write.imageInfo;
+			}
+			else {
+				descriptorWrite.pBufferInfo = &write.bufferInfo;
+			}
+		}
+
+		vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, NULL);
+
+		_writes.clear();
+		_writeIndices.clear();
+	}
+
+	void descriptorWriteBatch::discard(VkDescriptorSet set) {
+		for (size_t i = 0; i < _writes.size();) {
+			if (_writes[i].key.set == set) {
+				_writes[i] = _writes.back();
+				_writes.pop_back();
+			}
+			else {
+				++i;
+			}
+		}
+
+		// the indices of the moved writes have changed
+		_writeIndices.clear();
+		for (size_t i = 0; i < _writes.size(); ++i) {
+			_writeIndices[_writes[i].key] = i;
+		}
+	}
+
+	void descriptorWriteBatch::discard(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement) {
+		auto it = _writeIndices.find({ set, binding, arrayElement });
+		if (it == _writeIndices.end()) {
+			return;
+		}
+
+		// the last write takes the place of the discarded one
+		const size_t idx = it->second;
+		_writeIndices.erase(it);
+		if (idx != _writes.size() - 1) {
+			_writes[idx] = _writes.back();
+			_writeIndices[_writes[idx].key] = idx;
+		}
+		_writes.pop_back();
+	}
+
+	void descriptorWriteBatch::retarget(VkDescriptorSet set, VkDescriptorSet newSet) {
+		for (size_t i = 0; i < _writes.size(); ++i) {
+			if (_writes[i].key.set != set) {
+				continue;
+			}
+			_writeIndices.erase(_writes[i].key);
+			_writes[i].key.set = newSet;
+			_writeIndices[_writes[i].key] = i;
+		}
+	}
+
+	descriptorWriteBatch::pendingWrite& descriptorWriteBatch::getWrite(VkDescriptorSet set, const uint32_t binding, const uint32_t arrayElement) {
+		const writeKey key = { set, binding, arrayElement };
+
+		auto [it, inserted] = _writeIndices.emplace(key, _writes.size());
+		if (inserted) {
+			_writes.emplace_back();
+			_writes.back().key = key;
+		}
+		return _writes[it->second];
+	}
+}
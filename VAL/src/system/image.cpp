@@ -19,13 +19,23 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 
 namespace val {
 	void image::recreate(VAL_PROC& proc, const std::filesystem::path path, const VkFormat& format, const uint8_t& mipLevels /*DEFAULT=1U*/) {
-		vkDestroyImage(_device, _image, NULL);
-		vkFreeMemory(_device, _img_memory, NULL);
+		destroy();
 
 		create(proc, path, format, mipLevels);
 	}
 
-	void image::create(VAL_PROC& proc, const std::filesystem::path path, const VkFormat& format, const uint8_t& mipLevels, const VkSampleCountFlagBits& MSAA_samples) {
+	void image::destroy() {
+		if (_img_memory) {
+			_proc->destroyImage(_image, _img_memory);
+		}
+		if (_pixels) {
+			stbi_image_free(_pixels);
+			_pixels = NULL;
+		}
+	}
+
+	void image::create(VAL_PROC& proc, const std::filesystem::path path, const VkFormat& format, const uint8_t& mipLevels, const VkSampleCountFlagBits& MSAA_samples,
+		uploadBatch* batch /*NULL BY DEFAULT*/) {
 #ifndef NDEBUG
 		if (_image) {
 			printf("VAL: The create function should not be called on an already initialized image, use the recreate function instead. The memory address of _image is: %p", &_image);
@@ -37,102 +47,29 @@ namespace val {
 
 #endif // !NDEBUG
 
+		// the copy and the mipmap generation are recorded into one command buffer
+		uploadBatch localBatch(proc);
+		uploadBatch& cmds = batch ? *batch : localBatch;
+
 		_image = createTextureImage(&proc, path, &_pixels, format, _img_memory,
-			VkImageUsageFlagBits(0), mipLevels, &_width, &_height, &_channels);
+			VkImageUsageFlagBits(0), mipLevels, &_width, &_height, &_channels, GPU_ONLY, &cmds);
 		_device = proc._device;
+		_proc = &proc;
 		_format = format;
 		_mipLevels = mipLevels;
 
 		if (mipLevels > 0) {
-			generateMipmaps(proc, mipLevels);
+			generateMipmaps(proc, mipLevels, &cmds);
 		}
 	}
 
-	void image::generateMipmaps(VAL_PROC& proc, const uint8_t mipLevels) {
-		// Check if image format supports linear blitting
-		VkFormatProperties formatProperties;
-		vkGetPhysicalDeviceFormatProperties(proc._physicalDevice, _format, &formatProperties);
-
-		if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
-			throw std::runtime_error("texture image format does not support linear blitting!");
+	void image::generateMipmaps(VAL_PROC& proc, const uint8_t mipLevels, uploadBatch* batch /*NULL BY DEFAULT*/) {
+		if (batch) {
+			batch->generateMipMaps(_image, _format, _width, _height, mipLevels);
 		}
-
-		VkCommandBuffer commandBuffer = proc.beginSingleTimeCommands();
-
-		VkImageMemoryBarrier barrier{};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.image = _image;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = 1;
-		barrier.subresourceRange.levelCount = 1;
-
-		int32_t mipWidth = _width;
-		int32_t mipHeight = _height;
-
-		for (uint32_t i = 1; i < mipLevels; i++) {
-			barrier.subresourceRange.baseMipLevel = i - 1;
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-			vkCmdPipelineBarrier(commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
-				0, nullptr,
-				0, nullptr,
-				1, &barrier);
-
-			VkImageBlit blit{};
-			blit.srcOffsets[0] = { 0, 0, 0 };
-			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			blit.srcSubresource.mipLevel = i - 1;
-			blit.srcSubresource.baseArrayLayer = 0;
-			blit.srcSubresource.layerCount = 1;
-			blit.dstOffsets[0] = { 0, 0, 0 };
-			blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-			blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			blit.dstSubresource.mipLevel = i;
-			blit.dstSubresource.baseArrayLayer = 0;
-			blit.dstSubresource.layerCount = 1;
-
-			vkCmdBlitImage(commandBuffer,
-				_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-				_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				1, &blit,
-				VK_FILTER_LINEAR);
-
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-			vkCmdPipelineBarrier(commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-				0, nullptr,
-				0, nullptr,
-				1, &barrier);
-
-			if (mipWidth > 1) mipWidth /= 2;
-			if (mipHeight > 1) mipHeight /= 2;
+		else {
+			proc.generateMipMaps(_image, _format, _width, _height, mipLevels);
 		}
-
-		barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-		vkCmdPipelineBarrier(commandBuffer,
-			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier);
-
-		proc.endSingleTimeCommands(commandBuffer);
 	}
 
 
@@ -22,6 +22,11 @@ namespace val {
 		}
 		_aspectFlags = aspectFlags;
 		_proc.createImageView(texture.getVkImage(), texture.getVkFormat(), aspectFlags, &_imgView);
+
+		// textures get a stable index in the bindless set, that shaders can read them through
+		if (_proc._bindless.isCreated()) {
+			_bindlessIdx = _proc._bindless.addSampledImage(_imgView);
+		}
 	}
 
 	void imageView::create(VkImage img, VkFormat format, const VkImageAspectFlags& aspectFlags)
@@ -35,6 +40,13 @@ namespace val {
 
 	void imageView::destroy() 
 	{
+		// the pending bindless write of the view is dropped before the view is destroyed
+		if (_bindlessIdx != VAL_BINDLESS_INVALID_INDEX) {
+			if (_proc._bindless.isCreated()) {
+				_proc._bindless.remove(BINDLESS_BINDING::SAMPLED_IMAGES, _bindlessIdx);
+			}
+			_bindlessIdx = VAL_BINDLESS_INVALID_INDEX;
+		}
 		if (_imgView) {
 			vkDestroyImageView(_proc._device, _imgView, VK_NULL_HANDLE);
 			_imgView = NULL;
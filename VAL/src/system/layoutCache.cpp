@@ -0,0 +1,199 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <VAL/lib/system/layoutCache.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+
+namespace val {
+
+	// combines the hash of the value into the seed, like boost::hash_combine
+	template <typename T>
+	static void hashCombine(size_t& seed, const T& value) {
+		seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	static bool pushConstantRangesEqual(const std::vector<VkPushConstantRange>& a, const std::vector<VkPushConstantRange>& b) {
+		if (a.size() != b.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < a.size(); ++i) {
+			if (a[i].stageFlags != b[i].stageFlags || a[i].offset != b[i].offset || a[i].size != b[i].size) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void layoutCache::create(VkDevice device) {
+		_device = device;
+	}
+
+	void layoutCache::destroy() {
+		if (!_device) {
+			return;
+		}
+
+		for (auto& [key, layout] : _pipelineLayouts) {
+			vkDestroyPipelineLayout(_device, layout, NULL);
+		}
+		_pipelineLayouts.clear();
+		_pipelineLayoutKeys.clear();
+
+		for (auto& [key, layout] : _descriptorSetLayouts) {
+			vkDestroyDescriptorSetLayout(_device, layout, NULL);
+		}
+		_descriptorSetLayouts.clear();
+
+		for (VkDescriptorSetLayout layout : _uncachedDescriptorSetLayouts) {
+			vkDestroyDescriptorSetLayout(_device, layout, NULL);
+		}
+		_uncachedDescriptorSetLayouts.clear();
+
+		_device = VK_NULL_HANDLE;
+	}
+
+	VkDescriptorSetLayout layoutCache::getDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& createInfo) {
+		if (createInfo.pNext) {
+			VkDescriptorSetLayout layout;
+			if (vkCreateDescriptorSetLayout(_device, &createInfo, NULL, &layout) != VK_SUCCESS) {
+				throw std::runtime_error("VAL: FAILED TO CREATE DESCRIPTOR SET LAYOUT!");
+			}
+			_uncachedDescriptorSetLayouts.push_back(layout);
+			return layout;
+		}
+
+		descriptorSetLayoutKey key;
+		key.flags = createInfo.flags;
+		key.bindings.assign(createInfo.pBindings, createInfo.pBindings + createInfo.bindingCount);
+		std::sort(key.bindings.begin(), key.bindings.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+			return a.binding < b.binding;
+		});
+		for (VkDescriptorSetLayoutBinding& binding : key.bindings) {
+			if (binding.pImmutableSamplers) {
+				key.immutableSamplers.insert(key.immutableSamplers.end(), binding.pImmutableSamplers, binding.pImmutableSamplers + binding.descriptorCount);
+			}
+		}
+
+		auto it = _descriptorSetLayouts.find(key);
+		if (it != _descriptorSetLayouts.end()) {
+			return it->second;
+		}
+
+		VkDescriptorSetLayout layout;
+		if (vkCreateDescriptorSetLayout(_device, &createInfo, NULL, &layout) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: FAILED TO CREATE DESCRIPTOR SET LAYOUT!");
+		}
+		_descriptorSetLayouts.emplace(std::move(key), layout);
+		return layout;
+	}
+
+	VkPipelineLayout layoutCache::getPipelineLayout(const VkPipelineLayoutCreateInfo& createInfo) {
+		pipelineLayoutKey key;
+		key.flags = createInfo.flags;
+		key.setLayouts.assign(createInfo.pSetLayouts, createInfo.pSetLayouts + createInfo.setLayoutCount);
+		key.pushConstantRanges.assign(createInfo.pPushConstantRanges, createInfo.pPushConstantRanges + createInfo.pushConstantRangeCount);
+
+		auto it = _pipelineLayouts.find(key);
+		if (it != _pipelineLayouts.end()) {
+			return it->second;
+		}
+
+		VkPipelineLayout layout;
+		if (vkCreatePipelineLayout(_device, &createInfo, NULL, &layout) != VK_SUCCESS) {
+			throw std::runtime_error("FAILED TO CREATE VULKAN PIPELINE LAYOUT!");
+		}
+		auto inserted = _pipelineLayouts.emplace(std::move(key), layout).first;
+		_pipelineLayoutKeys.emplace(layout, &inserted->first);
+		return layout;
+	}
+
+	uint32_t layoutCache::getCompatibleSetCount(VkPipelineLayout layoutA, VkPipelineLayout layoutB) const {
+		auto itA = _pipelineLayoutKeys.find(layoutA);
+		auto itB = _pipelineLayoutKeys.find(layoutB);
+		if (itA == _pipelineLayoutKeys.end() || itB == _pipelineLayoutKeys.end()) {
+			return 0u;
+		}
+
+		const pipelineLayoutKey& a = *itA->second;
+		const pipelineLayoutKey& b = *itB->second;
+		if (a.flags != b.flags || !pushConstantRangesEqual(a.pushConstantRanges, b.pushConstantRanges)) {
+			return 0u;
+		}
+
+		// the set layouts are deduplicated by the cache, identically defined layouts have the same handle
+		uint32_t setCount = 0u;
+		while (setCount < a.setLayouts.size() && setCount < b.setLayouts.size() && a.setLayouts[setCount] == b.setLayouts[setCount]) {
+			++setCount;
+		}
+		return setCount;
+	}
+
+	/***************************************************/
+	/* KEYS */
+
+	bool layoutCache::descriptorSetLayoutKey::operator==(const descriptorSetLayoutKey& other) const {
+		if (flags != other.flags || bindings.size() != other.bindings.size() || immutableSamplers != other.immutableSamplers) {
+			return false;
+		}
+		for (size_t i = 0; i < bindings.size(); ++i) {
+			const VkDescriptorSetLayoutBinding& a = bindings[i];
+			const VkDescriptorSetLayoutBinding& b = other.bindings[i];
+			if (a.binding != b.binding || a.descriptorType != b.descriptorType || a.descriptorCount != b.descriptorCount
+				|| a.stageFlags != b.stageFlags || (a.pImmutableSamplers == NULL) != (b.pImmutableSamplers == NULL)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool layoutCache::pipelineLayoutKey::operator==(const pipelineLayoutKey& other) const {
+		return flags == other.flags && setLayouts == other.setLayouts && pushConstantRangesEqual(pushConstantRanges, other.pushConstantRanges);
+	}
+
+	size_t layoutCache::keyHasher::operator()(const descriptorSetLayoutKey& key) const {
+		size_t seed = 0u;
+		hashCombine(seed, key.flags);
+		for (const VkDescriptorSetLayoutBinding& binding : key.bindings) {
+			hashCombine(seed, binding.binding);
+			hashCombine(seed, (uint32_t)binding.descriptorType);
+			hashCombine(seed, binding.descriptorCount);
+			hashCombine(seed, binding.stageFlags);
+		}
+		for (VkSampler sampler : key.immutableSamplers) {
+			hashCombine(seed, sampler);
+		}
+		return seed;
+	}
+
+	size_t layoutCache::keyHasher::operator()(const pipelineLayoutKey& key) const {
+		size_t seed = 0u;
+		hashCombine(seed, key.flags);
+		for (VkDescriptorSetLayout setLayout : key.setLayouts) {
+			hashCombine(seed, setLayout);
+		}
+		for (const VkPushConstantRange& range : key.pushConstantRanges) {
+			hashCombine(seed, range.stageFlags);
+			hashCombine(seed, range.offset);
+			hashCombine(seed, range.size);
+		}
+		return seed;
+	}
+}
@@ -0,0 +1,321 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/memoryAllocator.hpp>
+#include <VAL/lib/debugReporting/debugCallbacks.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace val {
+
+	void memoryAllocator::create(VkPhysicalDevice physicalDevice, VkDevice device, const bool bufferDeviceAddress /*DEFAULT = false*/) {
+		_device = device;
+		_bufferDeviceAddress = bufferDeviceAddress;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &_memProperties);
+		_memoryTypeCache.clear();
+	}
+
+	void memoryAllocator::destroy() {
+		if (!_device) {
+			return;
+		}
+
+#ifndef NDEBUG
+		uint32_t leakedAllocations = _dedicatedAllocationCount;
+		for (const memoryBlock& block : _blocks) {
+			leakedAllocations += block.allocationCount;
+		}
+		if (leakedAllocations > 0u) {
+			dbg::printWarning("The memory allocator was destroyed with %u allocation(s) that were never freed.\n", leakedAllocations);
+		}
+#endif // !NDEBUG
+
+		for (uint32_t i = 0; i < _blocks.size(); ++i) {
+			destroyBlock(i);
+		}
+		_blocks.clear();
+		_memoryTypeCache.clear();
+		_dedicatedAllocationCount = 0u;
+		_allocatedBytes = 0u;
+		_device = VK_NULL_HANDLE;
+	}
+
+	uint32_t memoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+		const uint64_t key = (uint64_t(typeFilter) << 32) | uint64_t(properties);
+
+		const auto it = _memoryTypeCache.find(key);
+		if (it != _memoryTypeCache.end()) {
+			return it->second;
+		}
+
+		for (uint32_t i = 0; i < _memProperties.memoryTypeCount; i++) {
+			if ((typeFilter & (1 << i)) && (_memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+				_memoryTypeCache[key] = i;
+				return i;
+			}
+		}
+
+		throw std::runtime_error("VAL: FAILED TO FIND A SUITABLE MEMORY TYPE!");
+	}
+
+	memoryAllocation memoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, const bool linearResource) {
+		memoryAllocation alloc{};
+		alloc.memoryTypeIdx = findMemoryType(requirements.memoryTypeBits, properties);
+
+		const VkDeviceSize blockSize = getBlockSize(alloc.memoryTypeIdx);
+
+		// ranges are rounded up to a power of two that is at least as large as the alignment,
+		// buddies are always aligned to their own size, so this satisfies any alignment requirement.
+		VkDeviceSize rangeSize = VAL_MEMORY_MIN_ALLOCATION_SIZE;
+		uint8_t order = 0u;
+		while (rangeSize < requirements.size || rangeSize < requirements.alignment) {
+			rangeSize <<= 1;
+			++order;
+		}
+
+		// large resources are given their own VkDeviceMemory, as they would waste most of a block
+		if (rangeSize > blockSize / 2) {
+			alloc.memory = allocateDeviceMemory(requirements.size, alloc.memoryTypeIdx, &alloc.mapped);
+			alloc.offset = 0u;
+			alloc.size = requirements.size;
+			alloc.blockIdx = UINT32_MAX;
+
+			_dedicatedAllocationCount++;
+			_allocatedBytes += alloc.size;
+			return alloc;
+		}
+
+		uint32_t blockIdx = UINT32_MAX;
+		VkDeviceSize offset = 0u;
+		for (uint32_t i = 0; i < _blocks.size(); ++i) {
+			const memoryBlock& block = _blocks[i];
+			if (block.memory == VK_NULL_HANDLE || block.memoryTypeIdx != alloc.memoryTypeIdx || block.linear != linearResource) {
+				continue;
+			}
+			if (allocateFromBlock(i, order, offset)) {
+				blockIdx = i;
+				break;
+			}
+		}
+
+		if (blockIdx == UINT32_MAX) {
+			blockIdx = createBlock(alloc.memoryTypeIdx, linearResource);
+			// the block is empty, so this cannot fail
+			allocateFromBlock(blockIdx, order, offset);
+		}
+
+		memoryBlock& block = _blocks[blockIdx];
+		block.allocationCount++;
+
+		alloc.memory = block.memory;
+		alloc.offset = offset;
+		alloc.size = rangeSize;
+		alloc.blockIdx = blockIdx;
+		alloc.order = order;
+		alloc.mapped = block.mapped ? (void*)((uint8_t*)block.mapped + offset) : NULL;
+
+		_allocatedBytes += rangeSize;
+		return alloc;
+	}
+
+	void memoryAllocator::free(memoryAllocation& allocation) {
+		if (allocation.memory == VK_NULL_HANDLE) {
+			return;
+		}
+
+		if (allocation.blockIdx == UINT32_MAX) {
+			// vkFreeMemory implicitly unmaps the memory
+			vkFreeMemory(_device, allocation.memory, VK_NULL_HANDLE);
+			_dedicatedAllocationCount--;
+		}
+		else {
+#ifndef NDEBUG
+			if (allocation.blockIdx >= _blocks.size() || _blocks[allocation.blockIdx].memory != allocation.memory) {
+				dbg::printError("Attempted to free an allocation (memory: %p, offset: %llu) that does not belong to the memory allocator, or that has already been freed.\n",
+					allocation.memory, (unsigned long long)allocation.offset);
+				throw std::runtime_error("VAL: Attempted to free an invalid memory allocation!");
+			}
+#endif // !NDEBUG
+
+			memoryBlock& block = _blocks[allocation.blockIdx];
+
+			VkDeviceSize offset = allocation.offset;
+			uint8_t order = allocation.order;
+			// merge with the buddy for as long as it is free
+			while (order < block.maxOrder) {
+				const VkDeviceSize buddyOffset = offset ^ (VAL_MEMORY_MIN_ALLOCATION_SIZE << order);
+				const auto buddy = block.freeLists[order].find(buddyOffset);
+				if (buddy == block.freeLists[order].end()) {
+					break;
+				}
+				block.freeLists[order].erase(buddy);
+				offset = std::min(offset, buddyOffset);
+				++order;
+			}
+			block.freeLists[order].insert(offset);
+
+			block.allocationCount--;
+
+			// release empty blocks, unless it's the only block of it's kind (to avoid thrashing)
+			if (block.allocationCount == 0u) {
+				for (uint32_t i = 0; i < _blocks.size(); ++i) {
+					const memoryBlock& other = _blocks[i];
+					if (i != allocation.blockIdx && other.memory != VK_NULL_HANDLE && other.memoryTypeIdx == block.memoryTypeIdx && other.linear == block.linear) {
+						destroyBlock(allocation.blockIdx);
+						break;
+					}
+				}
+			}
+		}
+
+		_allocatedBytes -= allocation.size;
+		allocation = memoryAllocation{};
+	}
+
+	uint32_t memoryAllocator::getDeviceMemoryCount() const {
+		uint32_t count = _dedicatedAllocationCount;
+		for (const memoryBlock& block : _blocks) {
+			if (block.memory) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	VkDeviceSize memoryAllocator::getAllocatedBytes() const {
+		return _allocatedBytes;
+	}
+
+	const VkPhysicalDeviceMemoryProperties& memoryAllocator::getMemoryProperties() const {
+		return _memProperties;
+	}
+
+	/* PROTECTED: */
+
+	VkDeviceSize memoryAllocator::getBlockSize(const uint32_t memoryTypeIdx) const {
+		const VkDeviceSize heapSize = _memProperties.memoryHeaps[_memProperties.memoryTypes[memoryTypeIdx].heapIndex].size;
+
+		// small heaps (i.e. the 256MB BAR heap) use smaller blocks so that a single block can't hog the heap
+		VkDeviceSize blockSize = VAL_MEMORY_BLOCK_SIZE;
+		while (blockSize * 8u > heapSize && blockSize > VAL_MEMORY_MIN_ALLOCATION_SIZE * 4096u) {
+			blockSize >>= 1;
+		}
+		return blockSize;
+	}
+
+	uint32_t memoryAllocator::createBlock(const uint32_t memoryTypeIdx, const bool linear) {
+		// reuse an empty slot if there is one
+		uint32_t blockIdx = UINT32_MAX;
+		for (uint32_t i = 0; i < _blocks.size(); ++i) {
+			if (_blocks[i].memory == VK_NULL_HANDLE) {
+				blockIdx = i;
+				break;
+			}
+		}
+		if (blockIdx == UINT32_MAX) {
+			blockIdx = _blocks.size();
+			_blocks.emplace_back();
+		}
+
+		memoryBlock& block = _blocks[blockIdx];
+		block.size = getBlockSize(memoryTypeIdx);
+		block.memoryTypeIdx = memoryTypeIdx;
+		block.linear = linear;
+		block.allocationCount = 0u;
+		block.memory = allocateDeviceMemory(block.size, memoryTypeIdx, &block.mapped);
+
+		block.maxOrder = 0u;
+		while ((VAL_MEMORY_MIN_ALLOCATION_SIZE << block.maxOrder) < block.size) {
+			block.maxOrder++;
+		}
+
+		block.freeLists.clear();
+		block.freeLists.resize(block.maxOrder + 1u);
+		block.freeLists[block.maxOrder].insert(0u);
+
+		return blockIdx;
+	}
+
+	void memoryAllocator::destroyBlock(const uint32_t blockIdx) {
+		memoryBlock& block = _blocks[blockIdx];
+		if (block.memory) {
+			vkFreeMemory(_device, block.memory, VK_NULL_HANDLE);
+		}
+		block = memoryBlock{};
+	}
+
+	bool memoryAllocator::allocateFromBlock(const uint32_t blockIdx, const uint8_t order, VkDeviceSize& offsetOut) {
+		memoryBlock& block = _blocks[blockIdx];
+		if (order > block.maxOrder) {
+			return false;
+		}
+
+		// find the smallest free range that can hold the allocation
+		uint8_t freeOrder = order;
+		while (freeOrder <= block.maxOrder && block.freeLists[freeOrder].empty()) {
+			++freeOrder;
+		}
+		if (freeOrder > block.maxOrder) {
+			return false;
+		}
+
+		const VkDeviceSize offset = *block.freeLists[freeOrder].begin();
+		block.freeLists[freeOrder].erase(block.freeLists[freeOrder].begin());
+
+		// split the range until it's of the requested order, the upper halves are returned to the free lists
+		while (freeOrder > order) {
+			--freeOrder;
+			block.freeLists[freeOrder].insert(offset + (VAL_MEMORY_MIN_ALLOCATION_SIZE << freeOrder));
+		}
+
+		offsetOut = offset;
+		return true;
+	}
+
+	VkDeviceMemory memoryAllocator::allocateDeviceMemory(const VkDeviceSize size, const uint32_t memoryTypeIdx, void** mappedOut) {
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryTypeIdx;
+
+		// blocks are shared by many buffers, so the flag is set on all of them rather than on the buffers that need it
+		VkMemoryAllocateFlagsInfo flagsInfo{};
+		flagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+		flagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+		if (_bufferDeviceAddress) {
+			allocInfo.pNext = &flagsInfo;
+		}
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		if (vkAllocateMemory(_device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+#ifndef NDEBUG
+			dbg::printError("Failed to allocate %llu bytes of device memory of memory type %u.\n", (unsigned long long)size, memoryTypeIdx);
+#endif // !NDEBUG
+			throw std::runtime_error("VAL: FAILED TO ALLOCATE DEVICE MEMORY!");
+		}
+
+		*mappedOut = NULL;
+		// host visible memory is mapped once for the lifetime of the memory,
+		// as Vulkan does not allow the same VkDeviceMemory to be mapped more than once at a time.
+		if (_memProperties.memoryTypes[memoryTypeIdx].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+			vkMapMemory(_device, memory, 0u, VK_WHOLE_SIZE, 0u, mappedOut);
+		}
+
+		return memory;
+	}
+}
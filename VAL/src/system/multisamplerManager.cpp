@@ -22,12 +22,9 @@ namespace val
 	void multisamplerManager::destroy() {
 		const auto& device = _procVAL->_device;
 		if (_colorImage) {
-			vkDestroyImage(device, _colorImage, VK_NULL_HANDLE);
-			vkFreeMemory(device, _colorImageMemory, VK_NULL_HANDLE);
 			vkDestroyImageView(device, _colorImageView, VK_NULL_HANDLE);
+			_procVAL->destroyImage(_colorImage, _colorImageMemory);
 
-			_colorImage = VK_NULL_HANDLE;
-			_colorImageMemory = VK_NULL_HANDLE;
 			_colorImageView = VK_NULL_HANDLE;
 		}
 	}
@@ -37,7 +34,7 @@ namespace val
 	}
 
 	const VkDeviceMemory& multisamplerManager::getImageMemory() {
-		return _colorImageMemory;
+		return _colorImageMemory.memory;
 	}
 
 	const VkImageView& multisamplerManager::getVkImageView() {
@@ -0,0 +1,122 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <VAL/lib/system/pipelineCache.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+#include <stdexcept>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace val {
+
+	void pipelineCache::create(VAL_PROC& proc, const fs::path& filepath) {
+		_proc = &proc;
+		_filepath = filepath;
+		_loadedFromDisk = false;
+
+		std::vector<char> initialData;
+		if (!_filepath.empty() && readByteFile(_filepath.string(), &initialData)) {
+			if (validateHeader(initialData.data(), initialData.size())) {
+				_loadedFromDisk = true;
+			}
+			else {
+				dbg::printWarning("VAL: The pipeline cache at %s was created by a different driver or device and will be rebuilt.\n", _filepath.string().c_str());
+				initialData.clear();
+			}
+		}
+
+		VkPipelineCacheCreateInfo cacheInfo{};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		cacheInfo.initialDataSize = initialData.size();
+		cacheInfo.pInitialData = initialData.empty() ? NULL : initialData.data();
+
+		if (vkCreatePipelineCache(_proc->_device, &cacheInfo, NULL, &_cache) != VK_SUCCESS) {
+			// the driver may still reject data with a valid header, fall back to an empty cache
+			cacheInfo.initialDataSize = 0u;
+			cacheInfo.pInitialData = NULL;
+			_loadedFromDisk = false;
+			if (vkCreatePipelineCache(_proc->_device, &cacheInfo, NULL, &_cache) != VK_SUCCESS) {
+				throw std::runtime_error("VAL: FAILED TO CREATE PIPELINE CACHE!");
+			}
+		}
+	}
+
+	void pipelineCache::destroy() {
+		if (!isCreated()) {
+			return;
+		}
+
+		save();
+
+		vkDestroyPipelineCache(_proc->_device, _cache, NULL);
+		_cache = VK_NULL_HANDLE;
+		_proc = NULL;
+	}
+
+	bool pipelineCache::save() {
+		if (!isCreated() || _filepath.empty()) {
+			return false;
+		}
+
+		size_t dataSize = 0u;
+		if (vkGetPipelineCacheData(_proc->_device, _cache, &dataSize, NULL) != VK_SUCCESS || dataSize == 0u) {
+			return false;
+		}
+		std::vector<char> data(dataSize);
+		if (vkGetPipelineCacheData(_proc->_device, _cache, &dataSize, data.data()) != VK_SUCCESS) {
+			return false;
+		}
+
+		fs::path tmpPath = _filepath;
+		tmpPath += ".tmp";
+		{
+			std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+			if (!file.write(data.data(), dataSize)) {
+				dbg::printWarning("VAL: Failed to write the pipeline cache to %s\n", tmpPath.string().c_str());
+				return false;
+			}
+		}
+
+		// renaming replaces the old cache in one step
+		std::error_code err;
+		fs::rename(tmpPath, _filepath, err);
+		if (err) {
+			dbg::printWarning("VAL: Failed to replace the pipeline cache at %s: %s\n", _filepath.string().c_str(), err.message().c_str());
+			fs::remove(tmpPath, err);
+			return false;
+		}
+		return true;
+	}
+
+	bool pipelineCache::validateHeader(const char* data, const size_t size) const {
+		VkPipelineCacheHeaderVersionOne header;
+		if (size < sizeof(header)) {
+			return false;
+		}
+		memcpy(&header, data, sizeof(header));
+
+		const VkPhysicalDeviceProperties& properties = _proc->_physicalDeviceProperties;
+		return header.headerSize >= sizeof(header)
+			&& header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& header.vendorID == properties.vendorID
+			&& header.deviceID == properties.deviceID
+			&& memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+}
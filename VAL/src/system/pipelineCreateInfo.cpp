@@ -4,19 +4,25 @@
 #include <VAL/lib/system/imageView.hpp>
 
 #ifndef NDEBUG 
+#define VAL_VALIDATE_PUSH_DESCRIPTOR_TEMPLATE if (vkCmdPushDescriptorSetWithTemplateKHR == VK_NULL_HANDLE) {val::dbg::printError("Attempted to push descriptors with a template, but the push descriptor extension (VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) was not enabled in the physicalDeviceRequirements!\n");}
 #define VAL_VALIDATE_PUSH_DESCRIPTOR_EXT if (vkCmdPushDescriptorSetKHR == VK_NULL_HANDLE) {val::dbg::printError("Attempted to use push descriptors, but the push descriptor extension (VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) was not enabled in the physicalDeviceRequirements!\n");}
 #else
+#define VAL_VALIDATE_PUSH_DESCRIPTOR_TEMPLATE
 #define VAL_VALIDATE_PUSH_DESCRIPTOR_EXT
 #endif
 
 namespace val {
 
 	PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSetKHR = VK_NULL_HANDLE;
+	PFN_vkCmdPushDescriptorSetWithTemplateKHR vkCmdPushDescriptorSetWithTemplateKHR = VK_NULL_HANDLE;
 
 	void pipelineCreateInfo_loadvkCmdPushDescriptorSetKHR(VkDevice device) {
 		if (vkCmdPushDescriptorSetKHR == VK_NULL_HANDLE) {
 			vkCmdPushDescriptorSetKHR = (PFN_vkCmdPushDescriptorSetKHR)vkGetDeviceProcAddr(device, "vkCmdPushDescriptorSetKHR");
 		}
+		if (vkCmdPushDescriptorSetWithTemplateKHR == VK_NULL_HANDLE) {
+			vkCmdPushDescriptorSetWithTemplateKHR = (PFN_vkCmdPushDescriptorSetWithTemplateKHR)vkGetDeviceProcAddr(device, "vkCmdPushDescriptorSetWithTemplateKHR");
+		}
 	}
 
 
@@ -271,7 +277,7 @@ namespace val {
 	void pipelineCreateInfo::pushDescriptor_UNIFORM_BUFFER(VAL_PROC& proc, VkCommandBuffer cmdBuffer, const uint16_t bindingIdx, UBO_Handle& ubo) {
 		VAL_VALIDATE_PUSH_DESCRIPTOR_EXT;
 
-		const VkDescriptorBufferInfo bufferInfo{ ubo.getBuffer(proc), ubo._offset, ubo._size };
+		const VkDescriptorBufferInfo bufferInfo{ ubo.getBuffer(proc), ubo.getOffset(proc._currentFrame), ubo._size };
 
 		VkWriteDescriptorSet write{};
 		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -293,7 +299,7 @@ namespace val {
 	void pipelineCreateInfo::pushDescriptor_UNIFORM_BUFFER(VAL_PROC& proc, VkCommandBuffer cmdBuffer, const uint16_t bindingIdx, const uint16_t arrIndex, UBO_Handle& ubo) {
 		VAL_VALIDATE_PUSH_DESCRIPTOR_EXT;
 
-		const VkDescriptorBufferInfo bufferInfo{ ubo.getBuffer(proc), ubo._offset, ubo._size };
+		const VkDescriptorBufferInfo bufferInfo{ ubo.getBuffer(proc), ubo.getOffset(proc._currentFrame), ubo._size };
 
 		VkWriteDescriptorSet write{};
 		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -316,7 +322,7 @@ namespace val {
 	void pipelineCreateInfo::pushDescriptor_STORAGE_BUFFER(VAL_PROC& proc, VkCommandBuffer cmdBuffer, const uint16_t bindingIdx, SSBO_Handle& ssbo) {
 		VAL_VALIDATE_PUSH_DESCRIPTOR_EXT;
 
-		const VkDescriptorBufferInfo bufferInfo{ ssbo.getBuffer(proc), 0, ssbo._size };
+		const VkDescriptorBufferInfo bufferInfo{ ssbo.getBuffer(proc), ssbo.getOffset(proc._currentFrame), ssbo._size };
 
 		VkWriteDescriptorSet write{};
 		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -340,7 +346,7 @@ namespace val {
 	{
 		VAL_VALIDATE_PUSH_DESCRIPTOR_EXT;
 
-		const VkDescriptorBufferInfo bufferInfo{ ssbo.getBuffer(proc), 0, ssbo._size };
+		const VkDescriptorBufferInfo bufferInfo{ ssbo.getBuffer(proc), ssbo.getOffset(proc._currentFrame), ssbo._size };
 
 		VkWriteDescriptorSet write{};
 		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -361,6 +367,79 @@ namespace val {
 		);
 	}
 
+	void pipelineCreateInfo::pushDescriptorsWithTemplate(VAL_PROC& proc, VkCommandBuffer cmdBuffer, const void* data) {
+		VAL_VALIDATE_PUSH_DESCRIPTOR_TEMPLATE;
+
+		const descriptorUpdateTemplate& updateTemplate = proc._pushDescriptorUpdateTemplates[descriptorsIdx];
+#ifndef NDEBUG
+		if (!updateTemplate.isCreated()) {
+			dbg::printError("VAL: Attempted to push descriptors with a template, but pipeline %p has no push descriptors!\n", (void*)this);
+			return;
+		}
+#endif // !NDEBUG
+
+		// the template already knows the layout and set number
+		vkCmdPushDescriptorSetWithTemplateKHR(cmdBuffer, updateTemplate.getVkDescriptorUpdateTemplate(), VK_NULL_HANDLE, 0u, data);
+	}
+
+	void pipelineCreateInfo::updateDescriptorSetWithTemplate(VAL_PROC& proc, const uint8_t frameInFlight, const void* data,
+		const DESCRIPTOR_UPDATE_RATE updateRate /*DEFAULT = DESCRIPTOR_UPDATE_RATE::PER_FRAME*/)
+	{
+		if (frameInFlight >= proc._MAX_FRAMES_IN_FLIGHT) {
+			dbg::printError("VAL: Attempted to update the descriptor set of frame %u with a template, but there are only %u frames in flight!\n",
+				(uint32_t)frameInFlight, (uint32_t)proc._MAX_FRAMES_IN_FLIGHT);
+			return;
+		}
+
+		const descriptorUpdateTemplate& updateTemplate = proc._descriptorUpdateTemplates[descriptorsIdx][(uint32_t)updateRate];
+#ifndef NDEBUG
+		if (!updateTemplate.isCreated()) {
+			dbg::printError("VAL: Attempted to update a descriptor set with a template, but pipeline %p has no bindings of update rate %u or uses the descriptor buffer!\n",
+				(void*)this, (uint32_t)updateRate);
+			return;
+		}
+#endif // !NDEBUG
+
+		// every frame in flight may be using the static set, the template writes into the copy that replaces it
+		descriptorWriteBatch& queuedWrites = (updateRate == DESCRIPTOR_UPDATE_RATE::STATIC) ? proc._staticDescriptorWrites : proc._frameDescriptorWrites[frameInFlight];
+		if (updateRate == DESCRIPTOR_UPDATE_RATE::STATIC) {
+			proc.replaceStaticDescriptorSet(this);
+		}
+		VkDescriptorSet descriptorSet = proc.getDescriptorSet(*this, updateRate, frameInFlight);
+
+		// the queued writes to the bindings of the template would overwrite it when they're flushed, the other queued writes are kept
+		for (const descriptorUpdateTemplate::templateEntry& entry : updateTemplate.getEntries()) {
+			for (uint32_t arrayElement = 0u; arrayElement < entry.descriptorCount; ++arrayElement) {
+				queuedWrites.discard(descriptorSet, entry.binding, arrayElement);
+			}
+		}
+
+		vkUpdateDescriptorSetWithTemplate(proc._device, descriptorSet, updateTemplate.getVkDescriptorUpdateTemplate(), data);
+	}
+
+	const descriptorUpdateTemplate& pipelineCreateInfo::getDescriptorUpdateTemplate(VAL_PROC& proc,
+		const DESCRIPTOR_UPDATE_RATE updateRate /*DEFAULT = DESCRIPTOR_UPDATE_RATE::PER_FRAME*/) const
+	{
+		return proc._descriptorUpdateTemplates[descriptorsIdx][(uint32_t)updateRate];
+	}
+
+	const descriptorUpdateTemplate& pipelineCreateInfo::getPushDescriptorUpdateTemplate(VAL_PROC& proc) const {
+		return proc._pushDescriptorUpdateTemplates[descriptorsIdx];
+	}
+
+	DESCRIPTOR_UPDATE_RATE pipelineCreateInfo::getBindingUpdateRate(const uint32_t bindingIndex) const {
+		for (const std::pair<uint32_t, DESCRIPTOR_UPDATE_RATE>& bindingRate : bindingUpdateRates) {
+			if (bindingRate.first == bindingIndex) {
+				return bindingRate.second;
+			}
+		}
+		return DESCRIPTOR_UPDATE_RATE::PER_FRAME;
+	}
+
+	bool pipelineCreateInfo::isStaticBinding(const uint32_t bindingIndex) const {
+		return getBindingUpdateRate(bindingIndex) == DESCRIPTOR_UPDATE_RATE::STATIC;
+	}
+
 	bool pipelineCreateInfo::hasPushDescriptorLayout() {
 		return !(pushDescriptorsSetNo == UINT32_MAX);
 	}
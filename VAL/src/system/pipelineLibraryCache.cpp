@@ -0,0 +1,388 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <VAL/lib/system/pipelineLibraryCache.hpp>
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+namespace val {
+
+	// appends the bytes of the value to the key
+	template <typename T>
+	static void appendToKey(std::string& key, const T& value) {
+		key.append((const char*)&value, sizeof(T));
+	}
+
+	static void appendShaderStageToKey(std::string& key, const VkPipelineShaderStageCreateInfo& stage) {
+		appendToKey(key, stage.stage);
+		appendToKey(key, stage.module);
+		key.append(stage.pName);
+		key.push_back('\0');
+
+		const VkSpecializationInfo* specialization = stage.pSpecializationInfo;
+		appendToKey(key, specialization ? specialization->mapEntryCount : 0u);
+		if (specialization) {
+			for (uint32_t i = 0; i < specialization->mapEntryCount; ++i) {
+				appendToKey(key, specialization->pMapEntries[i].constantID);
+				appendToKey(key, specialization->pMapEntries[i].offset);
+				appendToKey(key, specialization->pMapEntries[i].size);
+			}
+			appendToKey(key, specialization->dataSize);
+			key.append((const char*)specialization->pData, specialization->dataSize);
+		}
+	}
+
+	// returns the VkPipelineRenderingCreateInfoKHR of a pipeline that uses dynamic rendering, or NULL
+	static const VkPipelineRenderingCreateInfoKHR* findRenderingInfo(const VkGraphicsPipelineCreateInfo& info) {
+		const VkBaseInStructure* next = (const VkBaseInStructure*)info.pNext;
+		while (next) {
+			if (next->sType == VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR) {
+				return (const VkPipelineRenderingCreateInfoKHR*)next;
+			}
+			next = next->pNext;
+		}
+		return NULL;
+	}
+
+	static void appendRenderPassToKey(std::string& key, const VkGraphicsPipelineCreateInfo& info) {
+		appendToKey(key, info.renderPass);
+		appendToKey(key, info.subpass);
+		// with dynamic rendering the parts are compatible with any attachments of the same formats
+		const VkPipelineRenderingCreateInfoKHR* renderingInfo = findRenderingInfo(info);
+		appendToKey(key, renderingInfo ? renderingInfo->colorAttachmentCount : 0u);
+		if (renderingInfo) {
+			for (uint32_t i = 0; i < renderingInfo->colorAttachmentCount; ++i) {
+				appendToKey(key, renderingInfo->pColorAttachmentFormats[i]);
+			}
+			appendToKey(key, renderingInfo->depthAttachmentFormat);
+			appendToKey(key, renderingInfo->stencilAttachmentFormat);
+			appendToKey(key, renderingInfo->viewMask);
+		}
+		appendToKey(key, info.pDynamicState ? info.pDynamicState->dynamicStateCount : 0u);
+		if (info.pDynamicState) {
+			for (uint32_t i = 0; i < info.pDynamicState->dynamicStateCount; ++i) {
+				appendToKey(key, info.pDynamicState->pDynamicStates[i]);
+			}
+		}
+	}
+
+	static void appendMultisampleStateToKey(std::string& key, const VkPipelineMultisampleStateCreateInfo* state) {
+		appendToKey(key, state != NULL);
+		if (state) {
+			appendToKey(key, state->rasterizationSamples);
+			appendToKey(key, state->sampleShadingEnable);
+			appendToKey(key, state->minSampleShading);
+			appendToKey(key, state->alphaToCoverageEnable);
+			appendToKey(key, state->alphaToOneEnable);
+		}
+	}
+
+	static void appendStencilOpToKey(std::string& key, const VkStencilOpState& state) {
+		appendToKey(key, state.failOp);
+		appendToKey(key, state.passOp);
+		appendToKey(key, state.depthFailOp);
+		appendToKey(key, state.compareOp);
+		appendToKey(key, state.compareMask);
+		appendToKey(key, state.writeMask);
+		appendToKey(key, state.reference);
+	}
+
+	void pipelineLibraryCache::create(VkDevice device, VkPipelineCache pipelineCache) {
+		_device = device;
+		_pipelineCache = pipelineCache;
+	}
+
+	void pipelineLibraryCache::destroy() {
+		if (!_device) {
+			return;
+		}
+
+		for (auto& [key, lib] : _libraries) {
+			vkDestroyPipeline(_device, lib.pipeline, NULL);
+		}
+		_libraries.clear();
+
+		_device = VK_NULL_HANDLE;
+		_pipelineCache = VK_NULL_HANDLE;
+	}
+
+	VkPipeline pipelineLibraryCache::link(const VkGraphicsPipelineCreateInfo& pipelineInfo) {
+		// every part only keeps the state that belongs to it, the states of the other parts are ignored by Vulkan
+		// the rendering info of dynamic rendering is the only extension struct that every part keeps
+		VkPipelineRenderingCreateInfoKHR renderingInfo{};
+		const VkPipelineRenderingCreateInfoKHR* pipelineRenderingInfo = findRenderingInfo(pipelineInfo);
+		if (pipelineRenderingInfo) {
+			renderingInfo = *pipelineRenderingInfo;
+			renderingInfo.pNext = NULL;
+		}
+
+		VkGraphicsPipelineCreateInfo baseInfo = pipelineInfo;
+		baseInfo.pNext = pipelineRenderingInfo ? &renderingInfo : NULL;
+		baseInfo.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+		baseInfo.stageCount = 0;
+		baseInfo.pStages = NULL;
+		baseInfo.pVertexInputState = NULL;
+		baseInfo.pInputAssemblyState = NULL;
+		baseInfo.pTessellationState = NULL;
+		baseInfo.pViewportState = NULL;
+		baseInfo.pRasterizationState = NULL;
+		baseInfo.pMultisampleState = NULL;
+		baseInfo.pDepthStencilState = NULL;
+		baseInfo.pColorBlendState = NULL;
+		baseInfo.basePipelineHandle = VK_NULL_HANDLE;
+		baseInfo.basePipelineIndex = -1;
+
+		std::vector<VkPipelineShaderStageCreateInfo> preRasterizationStages;
+		std::vector<VkPipelineShaderStageCreateInfo> fragmentStages;
+		for (uint32_t i = 0; i < pipelineInfo.stageCount; ++i) {
+			if (pipelineInfo.pStages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+				fragmentStages.push_back(pipelineInfo.pStages[i]);
+			}
+			else {
+				preRasterizationStages.push_back(pipelineInfo.pStages[i]);
+			}
+		}
+
+		VkPipeline libraries[4];
+
+		/*************************************************/
+		// vertex input interface
+		{
+			VkGraphicsPipelineCreateInfo partInfo = baseInfo;
+			partInfo.pVertexInputState = pipelineInfo.pVertexInputState;
+			partInfo.pInputAssemblyState = pipelineInfo.pInputAssemblyState;
+
+			std::string key;
+			appendToKey(key, VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT);
+			appendRenderPassToKey(key, pipelineInfo);
+			const VkPipelineVertexInputStateCreateInfo* vertexInput = pipelineInfo.pVertexInputState;
+			appendToKey(key, vertexInput->vertexBindingDescriptionCount);
+			for (uint32_t i = 0; i < vertexInput->vertexBindingDescriptionCount; ++i) {
+				appendToKey(key, vertexInput->pVertexBindingDescriptions[i].binding);
+				appendToKey(key, vertexInput->pVertexBindingDescriptions[i].stride);
+				appendToKey(key, vertexInput->pVertexBindingDescriptions[i].inputRate);
+			}
+			appendToKey(key, vertexInput->vertexAttributeDescriptionCount);
+			for (uint32_t i = 0; i < vertexInput->vertexAttributeDescriptionCount; ++i) {
+				appendToKey(key, vertexInput->pVertexAttributeDescriptions[i].location);
+				appendToKey(key, vertexInput->pVertexAttributeDescriptions[i].binding);
+				appendToKey(key, vertexInput->pVertexAttributeDescriptions[i].format);
+				appendToKey(key, vertexInput->pVertexAttributeDescriptions[i].offset);
+			}
+			appendToKey(key, pipelineInfo.pInputAssemblyState->topology);
+			appendToKey(key, pipelineInfo.pInputAssemblyState->primitiveRestartEnable);
+
+			libraries[0] = getLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, key, partInfo);
+		}
+
+		/*************************************************/
+		// pre-rasterization shaders
+		{
+			VkGraphicsPipelineCreateInfo partInfo = baseInfo;
+			partInfo.stageCount = (uint32_t)preRasterizationStages.size();
+			partInfo.pStages = preRasterizationStages.data();
+			partInfo.pTessellationState = pipelineInfo.pTessellationState;
+			partInfo.pViewportState = pipelineInfo.pViewportState;
+			partInfo.pRasterizationState = pipelineInfo.pRasterizationState;
+
+			std::string key;
+			appendToKey(key, VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+			appendRenderPassToKey(key, pipelineInfo);
+			appendToKey(key, pipelineInfo.layout);
+			for (const VkPipelineShaderStageCreateInfo& stage : preRasterizationStages) {
+				appendShaderStageToKey(key, stage);
+			}
+			const VkPipelineViewportStateCreateInfo* viewportState = pipelineInfo.pViewportState;
+			appendToKey(key, viewportState->viewportCount);
+			for (uint32_t i = 0; viewportState->pViewports && i < viewportState->viewportCount; ++i) {
+				appendToKey(key, viewportState->pViewports[i].x);
+				appendToKey(key, viewportState->pViewports[i].y);
+				appendToKey(key, viewportState->pViewports[i].width);
+				appendToKey(key, viewportState->pViewports[i].height);
+				appendToKey(key, viewportState->pViewports[i].minDepth);
+				appendToKey(key, viewportState->pViewports[i].maxDepth);
+			}
+			appendToKey(key, viewportState->scissorCount);
+			for (uint32_t i = 0; viewportState->pScissors && i < viewportState->scissorCount; ++i) {
+				appendToKey(key, viewportState->pScissors[i].offset.x);
+				appendToKey(key, viewportState->pScissors[i].offset.y);
+				appendToKey(key, viewportState->pScissors[i].extent.width);
+				appendToKey(key, viewportState->pScissors[i].extent.height);
+			}
+			const VkPipelineRasterizationStateCreateInfo* rasterizer = pipelineInfo.pRasterizationState;
+			appendToKey(key, rasterizer->depthClampEnable);
+			appendToKey(key, rasterizer->rasterizerDiscardEnable);
+			appendToKey(key, rasterizer->polygonMode);
+			appendToKey(key, rasterizer->cullMode);
+			appendToKey(key, rasterizer->frontFace);
+			appendToKey(key, rasterizer->depthBiasEnable);
+			appendToKey(key, rasterizer->depthBiasConstantFactor);
+			appendToKey(key, rasterizer->depthBiasClamp);
+			appendToKey(key, rasterizer->depthBiasSlopeFactor);
+			appendToKey(key, rasterizer->lineWidth);
+
+			libraries[1] = getLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT, key, partInfo);
+		}
+
+		/*************************************************/
+		// fragment shader
+		{
+			VkGraphicsPipelineCreateInfo partInfo = baseInfo;
+			partInfo.stageCount = (uint32_t)fragmentStages.size();
+			partInfo.pStages = fragmentStages.data();
+			partInfo.pMultisampleState = pipelineInfo.pMultisampleState;
+			partInfo.pDepthStencilState = pipelineInfo.pDepthStencilState;
+
+			std::string key;
+			appendToKey(key, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
+			appendRenderPassToKey(key, pipelineInfo);
+			appendToKey(key, pipelineInfo.layout);
+			for (const VkPipelineShaderStageCreateInfo& stage : fragmentStages) {
+				appendShaderStageToKey(key, stage);
+			}
+			appendMultisampleStateToKey(key, pipelineInfo.pMultisampleState);
+			const VkPipelineDepthStencilStateCreateInfo* depthStencil = pipelineInfo.pDepthStencilState;
+			appendToKey(key, depthStencil != NULL);
+			if (depthStencil) {
+				appendToKey(key, depthStencil->depthTestEnable);
+				appendToKey(key, depthStencil->depthWriteEnable);
+				appendToKey(key, depthStencil->depthCompareOp);
+				appendToKey(key, depthStencil->depthBoundsTestEnable);
+				appendToKey(key, depthStencil->stencilTestEnable);
+				appendStencilOpToKey(key, depthStencil->front);
+				appendStencilOpToKey(key, depthStencil->back);
+				appendToKey(key, depthStencil->minDepthBounds);
+				appendToKey(key, depthStencil->maxDepthBounds);
+			}
+
+			libraries[2] = getLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, key, partInfo);
+		}
+
+		/*************************************************/
+		// fragment output interface
+		{
+			VkGraphicsPipelineCreateInfo partInfo = baseInfo;
+			partInfo.pMultisampleState = pipelineInfo.pMultisampleState;
+			partInfo.pColorBlendState = pipelineInfo.pColorBlendState;
+
+			std::string key;
+			appendToKey(key, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+			appendRenderPassToKey(key, pipelineInfo);
+			appendMultisampleStateToKey(key, pipelineInfo.pMultisampleState);
+			const VkPipelineColorBlendStateCreateInfo* colorBlend = pipelineInfo.pColorBlendState;
+			appendToKey(key, colorBlend != NULL);
+			if (colorBlend) {
+				appendToKey(key, colorBlend->logicOpEnable);
+				appendToKey(key, colorBlend->logicOp);
+				for (const float constant : colorBlend->blendConstants) {
+					appendToKey(key, constant);
+				}
+				appendToKey(key, colorBlend->attachmentCount);
+				for (uint32_t i = 0; i < colorBlend->attachmentCount; ++i) {
+					const VkPipelineColorBlendAttachmentState& attachment = colorBlend->pAttachments[i];
+					appendToKey(key, attachment.blendEnable);
+					appendToKey(key, attachment.srcColorBlendFactor);
+					appendToKey(key, attachment.dstColorBlendFactor);
+					appendToKey(key, attachment.colorBlendOp);
+					appendToKey(key, attachment.srcAlphaBlendFactor);
+					appendToKey(key, attachment.dstAlphaBlendFactor);
+					appendToKey(key, attachment.alphaBlendOp);
+					appendToKey(key, attachment.colorWriteMask);
+				}
+			}
+
+			libraries[3] = getLibrary(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT, key, partInfo);
+		}
+
+		/*************************************************/
+		// link the parts, without link time optimization so that the link is fast
+
+		VkPipelineLibraryCreateInfoKHR libraryInfo{};
+		libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+		libraryInfo.libraryCount = 4;
+		libraryInfo.pLibraries = libraries;
+
+		VkGraphicsPipelineCreateInfo linkInfo{};
+		linkInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		linkInfo.pNext = &libraryInfo;
+		linkInfo.layout = pipelineInfo.layout;
+
+		VkPipeline pipeline;
+		if (vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &linkInfo, NULL, &pipeline) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: FAILED TO LINK GRAPHICS PIPELINE LIBRARIES!");
+		}
+		return pipeline;
+	}
+
+	void pipelineLibraryCache::evictModule(VkShaderModule module) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (auto it = _libraries.begin(); it != _libraries.end();) {
+			const std::vector<VkShaderModule>& modules = it->second.modules;
+			if (std::find(modules.begin(), modules.end(), module) != modules.end()) {
+				// pipelines that were linked from the library remain valid
+				vkDestroyPipeline(_device, it->second.pipeline, NULL);
+				it = _libraries.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+	}
+
+	size_t pipelineLibraryCache::getLibraryCount() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _libraries.size();
+	}
+
+	VkPipeline pipelineLibraryCache::getLibrary(const VkGraphicsPipelineLibraryFlagsEXT part, const std::string& key, const VkGraphicsPipelineCreateInfo& partInfo) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			auto it = _libraries.find(key);
+			if (it != _libraries.end()) {
+				return it->second.pipeline;
+			}
+		}
+
+		// the part is compiled outside of the lock, so that other threads can compile or link in the meantime
+		VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{};
+		libraryInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+		libraryInfo.flags = part;
+		libraryInfo.pNext = partInfo.pNext;
+
+		VkGraphicsPipelineCreateInfo info = partInfo;
+		info.pNext = &libraryInfo;
+
+		library lib;
+		if (vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &info, NULL, &lib.pipeline) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: FAILED TO CREATE GRAPHICS PIPELINE LIBRARY!");
+		}
+		for (uint32_t i = 0; i < partInfo.stageCount; ++i) {
+			lib.modules.push_back(partInfo.pStages[i].module);
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto [it, inserted] = _libraries.emplace(key, lib);
+		if (!inserted) {
+			// another thread compiled the same part first
+			vkDestroyPipeline(_device, lib.pipeline, NULL);
+		}
+		return it->second.pipeline;
+	}
+}
@@ -0,0 +1,325 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <VAL/lib/system/pipelineVariantCache.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+#include <stdexcept>
+
+namespace val {
+
+	// appends the bytes of the value to the key
+	template <typename T>
+	static void appendToKey(std::string& key, const T& value) {
+		key.append((const char*)&value, sizeof(T));
+	}
+
+	static void appendStencilOpToKey(std::string& key, const VkStencilOpState& state) {
+		appendToKey(key, state.failOp);
+		appendToKey(key, state.passOp);
+		appendToKey(key, state.depthFailOp);
+		appendToKey(key, state.compareOp);
+		appendToKey(key, state.compareMask);
+		appendToKey(key, state.writeMask);
+		appendToKey(key, state.reference);
+	}
+
+	void pipelineVariantCache::create(VAL_PROC& proc) {
+		_proc = &proc;
+	}
+
+	void pipelineVariantCache::destroy() {
+		if (!_proc) {
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_jobQueued.notify_all();
+		if (_worker.joinable()) {
+			_worker.join();
+		}
+
+		for (auto& [key, pipeline] : _variants) {
+			if (pipeline) {
+				vkDestroyPipeline(_proc->_device, pipeline, NULL);
+			}
+		}
+		_variants.clear();
+		_failedVariants.clear();
+		_jobs.clear();
+
+		_stopping = false;
+		_proc = NULL;
+	}
+
+	VkPipeline pipelineVariantCache::get(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant) {
+		const std::string key = buildKey(base, variant);
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		auto it = _variants.find(key);
+		// the variant is being compiled on another thread, waiting for it is cheaper than compiling it twice
+		while (it != _variants.end() && it->second == VK_NULL_HANDLE) {
+			_variantCompiled.wait(lock);
+			it = _variants.find(key);
+		}
+		if (it != _variants.end()) {
+			return it->second;
+		}
+		// the key is reserved before compiling, so that concurrent requests for the variant wait for this compilation
+		_variants.emplace(key, VK_NULL_HANDLE);
+		lock.unlock();
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		try {
+			pipeline = _proc->compileGraphicsPipeline(base, &variant);
+		}
+		catch (...) {
+			lock.lock();
+			_variants.erase(key);
+			lock.unlock();
+			_variantCompiled.notify_all();
+			throw;
+		}
+
+		lock.lock();
+		_variants[key] = pipeline;
+		_failedVariants.erase(key);
+		lock.unlock();
+		_variantCompiled.notify_all();
+		return pipeline;
+	}
+
+	VkPipeline pipelineVariantCache::getAsync(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant, VkPipeline fallback) {
+		std::string key = buildKey(base, variant);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _variants.find(key);
+		if (it != _variants.end()) {
+			return it->second ? it->second : fallback;
+		}
+		if (_failedVariants.count(key)) {
+			return fallback;
+		}
+		_variants.emplace(key, VK_NULL_HANDLE);
+
+		std::unique_ptr<compileJob> job = std::make_unique<compileJob>();
+		job->key = std::move(key);
+		job->base = &base;
+		job->layout = _proc->_pipelineLayouts[base.pipelineIdx];
+		job->shaderModules = _proc->_pipelineShaderModules[base.descriptorsIdx];
+		job->variant.specializationValues = variant.specializationValues;
+		if (variant.rasterizer) {
+			job->rasterizer = *variant.rasterizer;
+			job->variant.rasterizer = &job->rasterizer;
+		}
+		if (variant.depthStencil) {
+			job->depthStencil = *variant.depthStencil;
+			job->variant.depthStencil = &job->depthStencil;
+		}
+		if (variant.colorBlend) {
+			job->colorBlend = *variant.colorBlend;
+			job->blendAttachments.reserve(variant.colorBlend->_attachments.size());
+			for (size_t i = 0; i < variant.colorBlend->_attachments.size(); ++i) {
+				job->blendAttachments.push_back(*variant.colorBlend->_attachments[i]);
+				job->colorBlend._attachments[i] = &job->blendAttachments[i];
+			}
+			job->variant.colorBlend = &job->colorBlend;
+		}
+		_jobs.push_back(std::move(job));
+
+		if (!_worker.joinable()) {
+			_worker = std::thread(&pipelineVariantCache::workerLoop, this);
+		}
+		_jobQueued.notify_one();
+
+		return fallback;
+	}
+
+	bool pipelineVariantCache::isCompiled(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant) {
+		const std::string key = buildKey(base, variant);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _variants.find(key);
+		return it != _variants.end() && it->second != VK_NULL_HANDLE;
+	}
+
+	void pipelineVariantCache::removeVariantsOf(const graphicsPipelineCreateInfo& base, std::vector<VkPipeline>& pipelinesOut) {
+		if (!_proc) {
+			return;
+		}
+
+		// every key begins with the index of it's base pipeline
+		std::string prefix;
+		appendToKey(prefix, base.pipelineIdx);
+		const auto isVariantOfBase = [&prefix](const std::string& key) { return key.compare(0, prefix.size(), prefix) == 0; };
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		for (auto it = _jobs.begin(); it != _jobs.end();) {
+			if ((*it)->base == &base) {
+				_variants.erase((*it)->key);
+				it = _jobs.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+		// threads that were waiting for a dropped job compile the variant themselves
+		_variantCompiled.notify_all();
+
+		const auto isCompiling = [&]() {
+			for (const auto& [key, pipeline] : _variants) {
+				if (pipeline == VK_NULL_HANDLE && isVariantOfBase(key)) {
+					return true;
+				}
+			}
+			return false;
+		};
+		_variantCompiled.wait(lock, [&]() { return !isCompiling(); });
+
+		for (auto it = _variants.begin(); it != _variants.end();) {
+			if (isVariantOfBase(it->first)) {
+				pipelinesOut.push_back(it->second);
+				it = _variants.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+		// the index of the base may be reused by a new pipeline
+		for (auto it = _failedVariants.begin(); it != _failedVariants.end();) {
+			if (isVariantOfBase(*it)) {
+				it = _failedVariants.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+	}
+
+	size_t pipelineVariantCache::getVariantCount() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _variants.size();
+	}
+
+	std::string pipelineVariantCache::buildKey(const graphicsPipelineCreateInfo& base, const pipelineVariant& variant) {
+		std::string key;
+		key.reserve(256);
+
+		appendToKey(key, base.pipelineIdx);
+
+		appendToKey(key, (uint32_t)variant.specializationValues.size());
+		for (const pipelineVariant::specializationValue& value : variant.specializationValues) {
+			appendToKey(key, value.shaderIdx);
+			appendToKey(key, value.constantID);
+			appendToKey(key, (uint32_t)value.data.size());
+			key.append(value.data.data(), value.data.size());
+		}
+
+		appendToKey(key, variant.rasterizer != NULL);
+		if (variant.rasterizer) {
+			const VkPipelineRasterizationStateCreateInfo& state = *variant.rasterizer->getVkPipelineRasterizationStateCreateInfo();
+			appendToKey(key, state.depthClampEnable);
+			appendToKey(key, state.rasterizerDiscardEnable);
+			appendToKey(key, state.polygonMode);
+			appendToKey(key, state.cullMode);
+			appendToKey(key, state.frontFace);
+			appendToKey(key, state.depthBiasEnable);
+			appendToKey(key, state.depthBiasConstantFactor);
+			appendToKey(key, state.depthBiasClamp);
+			appendToKey(key, state.depthBiasSlopeFactor);
+			appendToKey(key, state.lineWidth);
+		}
+
+		appendToKey(key, variant.depthStencil != NULL);
+		if (variant.depthStencil) {
+			const VkPipelineDepthStencilStateCreateInfo& state = variant.depthStencil->getVkPipelineDepthStencilStateCreateInfo();
+			appendToKey(key, state.depthTestEnable);
+			appendToKey(key, state.depthWriteEnable);
+			appendToKey(key, state.depthCompareOp);
+			appendToKey(key, state.depthBoundsTestEnable);
+			appendToKey(key, state.stencilTestEnable);
+			appendStencilOpToKey(key, state.front);
+			appendStencilOpToKey(key, state.back);
+			appendToKey(key, state.minDepthBounds);
+			appendToKey(key, state.maxDepthBounds);
+		}
+
+		appendToKey(key, variant.colorBlend != NULL);
+		if (variant.colorBlend) {
+			const colorBlendState& state = *variant.colorBlend;
+			appendToKey(key, state._logicOpEnabled);
+			appendToKey(key, state._logicOp);
+			for (const float constant : state._blendConstantsColors) {
+				appendToKey(key, constant);
+			}
+			appendToKey(key, (uint32_t)state._attachments.size());
+			for (colorBlendStateAttachment* attachment : state._attachments) {
+				const VkPipelineColorBlendAttachmentState& attachmentState = attachment->getVkColorBlendAttachmentState();
+				appendToKey(key, attachmentState.blendEnable);
+				appendToKey(key, attachmentState.srcColorBlendFactor);
+				appendToKey(key, attachmentState.dstColorBlendFactor);
+				appendToKey(key, attachmentState.colorBlendOp);
+				appendToKey(key, attachmentState.srcAlphaBlendFactor);
+				appendToKey(key, attachmentState.dstAlphaBlendFactor);
+				appendToKey(key, attachmentState.alphaBlendOp);
+				appendToKey(key, attachmentState.colorWriteMask);
+			}
+		}
+
+		return key;
+	}
+
+	void pipelineVariantCache::workerLoop() {
+		while (true) {
+			std::unique_ptr<compileJob> job;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_jobQueued.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+				if (_stopping) {
+					return;
+				}
+				job = std::move(_jobs.front());
+				_jobs.pop_front();
+			}
+
+			VkPipeline pipeline = VK_NULL_HANDLE;
+			try {
+				pipeline = _proc->compileGraphicsPipeline(*job->base, job->layout, job->shaderModules, &job->variant);
+			}
+			catch (const std::exception& e) {
+				dbg::printError("VAL: Failed to compile a pipeline variant of pipeline %u on the background thread: %s\n", job->base->pipelineIdx, e.what());
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (pipeline) {
+					_variants[job->key] = pipeline;
+				}
+				else {
+					// getAsync keeps returning the fallback, get() compiles it on the calling thread where the error can be handled
+					_variants.erase(job->key);
+					_failedVariants.insert(job->key);
+				}
+			}
+			_variantCompiled.notify_all();
+		}
+	}
+}
@@ -11,26 +11,42 @@ namespace val
 		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
 		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
 
-		int i = 0;
-		for (const auto& queueFamily : queueFamilies) {
+		// families are prefered if they have fewer capabilities besides the requested ones,
+		// so that the transfer queue is mapped to a dedicated transfer family if the device has one.
+		const VkQueueFlags capabilityFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+		uint32_t fewestExtraCapabilities = UINT32_MAX;
+
+		for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+			const VkQueueFamilyProperties& queueFamily = queueFamilies[i];
 			if (isPresentQueue) {
 				VkBool32 presentSupport = false;
-				_queueFamily = i;
 				vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
-#ifndef NDEBUG
-				if (!presentSupport) {
-					printf("VAL: PRESENT QUEUE REQUESTED, BUT IS NOT AVAILABLE ON THIS DEVICE!\n");
+				if (presentSupport) {
+					_queueFamily = i;
+					return _queueFamily;
 				}
-#endif // !NDEBUG
-				return _queueFamily;
+				continue;
 			}
 
-			if (queueFamily.queueFlags & _queueFlags) {
-				_queueFamily = i;
-				return _queueFamily;
+			if ((queueFamily.queueFlags & _queueFlags) == _queueFlags) {
+				uint32_t extraCapabilities = 0u;
+				for (VkQueueFlags extraFlags = queueFamily.queueFlags & capabilityFlags & ~_queueFlags; extraFlags; extraFlags &= extraFlags - 1) {
+					++extraCapabilities;
+				}
+
+				if (extraCapabilities < fewestExtraCapabilities) {
+					fewestExtraCapabilities = extraCapabilities;
+					_queueFamily = i;
+				}
 			}
 		}
 
+#ifndef NDEBUG
+		if (isPresentQueue) {
+			printf("VAL: PRESENT QUEUE REQUESTED, BUT IS NOT AVAILABLE ON THIS DEVICE!\n");
+		}
+#endif // !NDEBUG
+
 		return _queueFamily;
 	}
 
@@ -20,7 +20,43 @@ TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR TH
 #include <VAL/lib/system/VAL_PROC.hpp>
 #include <VAL/lib/system/system_utils.hpp>
 
+#include <algorithm>
+
 namespace val {
+	// records a layout transition of every mip level and layer of the image
+	static void recordImageBarrier(VkCommandBuffer commandBuffer, VkImage image, const VkImageAspectFlags aspect, const VkImageLayout oldLayout, const VkImageLayout newLayout,
+		const VkPipelineStageFlags srcStage, const VkAccessFlags srcAccess, const VkPipelineStageFlags dstStage, const VkAccessFlags dstAccess)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = aspect;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstAccessMask = dstAccess;
+
+		vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, NULL, 0, NULL, 1, &barrier);
+	}
+
+	// the dynamic state commands that aren't available on the device are NULL, calling them would crash
+	#define VAL_VALIDATE_DYNAMIC_STATE_COMMAND(fn, name, extension) if (fn == NULL) { \
+		dbg::printError("VAL: Attempted to set " name " dynamically, but it isn't supported by the device or " extension " was not enabled in the physicalDeviceRequirements!\n"); \
+		throw std::runtime_error("VAL: " name " can't be set dynamically, " extension " is not enabled!"); }
+	#define VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(fn, name) VAL_VALIDATE_DYNAMIC_STATE_COMMAND(fn, name, "VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME")
+	#define VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_2(fn, name) VAL_VALIDATE_DYNAMIC_STATE_COMMAND(fn, name, "VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME")
+	#define VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_3(fn, name) VAL_VALIDATE_DYNAMIC_STATE_COMMAND(fn, name, "VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME")
+
+	static bool formatHasStencil(const VkFormat format) {
+		return format == VK_FORMAT_S8_UINT || format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+	}
+
 	void renderTarget::render(VAL_PROC& proc, const uint32_t& instanceCount /*DEFAULT = 1U*/)
 	{
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
@@ -34,113 +70,367 @@ namespace val {
 	}
 
 	void renderTarget::rebindDescriptorSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline) {
-		const auto& pipelineIdx = pipeline.pipelineIdx;
+		// the pipeline and it's descriptor set are only recorded again if something else was bound in between
+		bindPipeline(proc, pipeline, proc.getGraphicsPipeline(pipeline));
+	}
+
+	void renderTarget::rebindDescriptorSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const uint32_t* dynamicOffsets, const uint32_t dynamicOffsetCount) {
+#ifndef NDEBUG
+		if (dynamicOffsetCount != pipeline.defaultDynamicOffsets.size()) {
+			printf("VAL: ERROR: The descriptor set of pipeline %d has %zu dynamic descriptors, but %d dynamic offsets were given!\n",
+				pipeline.pipelineIdx, pipeline.defaultDynamicOffsets.size(), dynamicOffsetCount);
+			throw std::runtime_error("VAL: ERROR: The number of dynamic offsets must equal the number of dynamic descriptors in the descriptor set!");
+		}
+#endif // !NDEBUG
+
+		// pipelines that use the descriptor buffer have no dynamic descriptors
+		if (pipeline.useDescriptorBuffer) {
+			setDescriptorBufferOffset(proc, pipeline, proc._descriptorBufferOffsets[pipeline.descriptorsIdx][proc._currentFrame]);
+			return;
+		}
+
+		// only the descriptor sets are rebound, the pipeline stays bound
+		bindDescriptorSets(proc, pipeline, dynamicOffsets);
+	}
+
+	void renderTarget::bindDescriptorSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const DESCRIPTOR_UPDATE_RATE updateRate, VkDescriptorSet descriptorSet,
+		const uint32_t* dynamicOffsets /*DEFAULT = NULL*/, const uint32_t dynamicOffsetCount /*DEFAULT = 0u*/)
+	{
+		const uint32_t setNo = pipeline.getSetNo(updateRate);
+#ifndef NDEBUG
+		if (setNo == UINT32_MAX || pipeline.useDescriptorBuffer) {
+			printf("VAL: ERROR: Pipeline %d has no descriptor set of update rate %d!\n", pipeline.pipelineIdx, (uint32_t)updateRate);
+			throw std::runtime_error("VAL: ERROR: The pipeline has no descriptor set of the update rate!");
+		}
+		if (dynamicOffsetCount != pipeline.setDynamicOffsetCounts[setNo]) {
+			printf("VAL: ERROR: Descriptor set %d of pipeline %d has %d dynamic descriptors, but %d dynamic offsets were given!\n",
+				setNo, pipeline.pipelineIdx, pipeline.setDynamicOffsetCounts[setNo], dynamicOffsetCount);
+			throw std::runtime_error("VAL: ERROR: The number of dynamic offsets must equal the number of dynamic descriptors in the descriptor set!");
+		}
+#endif // !NDEBUG
+
+		// binding a set with a different layout disturbs the bound sets that aren't compatible with it
+		const VkPipelineLayout layout = proc._pipelineLayouts[pipeline.pipelineIdx];
+		changeBoundPipelineLayout(proc, layout);
+		_userBoundDescriptorSets[setNo] = true;
+
+		std::vector<uint32_t>& boundOffsets = _boundDynamicOffsets[setNo];
+		if (descriptorSet == _boundDescriptorSets[setNo] && dynamicOffsetCount == boundOffsets.size() &&
+			std::equal(dynamicOffsets, dynamicOffsets + dynamicOffsetCount, boundOffsets.begin()))
+		{
+			++_bindStats.descriptorSetBindsSkipped;
+			return;
+		}
+
+		vkCmdBindDescriptorSets(proc._graphicsQueue._commandBuffers[proc._currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+			setNo, 1, &descriptorSet, dynamicOffsetCount, dynamicOffsets);
+		++_bindStats.descriptorSetBinds;
+		_boundDescriptorSets[setNo] = descriptorSet;
+		boundOffsets.assign(dynamicOffsets, dynamicOffsets + dynamicOffsetCount);
+		_boundDescriptorBufferOffset = VK_WHOLE_SIZE;
+	}
+
+	void renderTarget::setDescriptorBufferOffset(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const VkDeviceSize offset) {
+#ifndef NDEBUG
+		if (!pipeline.useDescriptorBuffer) {
+			printf("VAL: ERROR: Pipeline %d doesn't use the descriptor buffer, it's descriptor set can't be bound by an offset!\n", pipeline.pipelineIdx);
+			throw std::runtime_error("VAL: ERROR: The pipeline doesn't use the descriptor buffer!");
+		}
+#endif // !NDEBUG
+
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		// bind pipeline and respective descriptor sets
-		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, proc._graphicsPipelines[pipelineIdx]);
-		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, proc._pipelineLayouts[pipelineIdx],
-			0, 1, &proc._descriptorSets[pipelineIdx][proc._currentFrame], 0, nullptr);
+
+		// the buffer stays bound for the rest of the command buffer, only the offsets change between pipelines and draws
+		if (!_descriptorBufferBound) {
+			proc._descriptorBuffer.bind(commandBuffer);
+			_descriptorBufferBound = true;
+		}
+
+		const VkPipelineLayout layout = proc._pipelineLayouts[pipeline.pipelineIdx];
+		if (layout == _boundPipelineLayout && offset == _boundDescriptorBufferOffset) {
+			++_bindStats.descriptorSetBindsSkipped;
+			return;
+		}
+
+		proc._descriptorBuffer.setOffset(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, offset);
+		++_bindStats.descriptorSetBinds;
+		// setting the offsets invalidates the descriptor sets that were bound at the same set numbers, the bindless set included
+		_boundPipelineLayout = layout;
+		invalidateDescriptorSets();
+		_boundBindlessLayout = VK_NULL_HANDLE;
+		_boundDescriptorBufferOffset = offset;
 	}
 
 	void renderTarget::updatePipeline(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline)
 	{
-		const auto& pipelineIdx = pipeline.pipelineIdx;
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		// bind pipeline and respective descriptor sets
-		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, proc._graphicsPipelines[pipelineIdx]);
-		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, proc._pipelineLayouts[pipelineIdx],
-			0, 1, &proc._descriptorSets[pipelineIdx][proc._currentFrame], 0, nullptr);
+		bindPipeline(proc, pipeline, proc.getGraphicsPipeline(pipeline));
+	}
+
+	void renderTarget::updatePipeline(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const pipelineVariant& variant, const bool compileAsync /*DEFAULT = false*/)
+	{
+		const VkPipeline vkPipeline = compileAsync ? proc.getPipelineVariantAsync(pipeline, variant) : proc.getPipelineVariant(pipeline, variant);
+		bindPipeline(proc, pipeline, vkPipeline);
 	}
 
 	void renderTarget::updateViewport(VAL_PROC& proc, const VkViewport& viewport)
 	{
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		updateViewport(proc, viewport, 0u);
 	}
 
 	void renderTarget::updateViewport(VAL_PROC& proc, const VkViewport& viewport, const uint16_t index)
 	{
+		if (!countDynamicState(_boundViewports.change(index, 1u, &viewport))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		vkCmdSetViewport(commandBuffer, index, 1, &viewport);
 	}
 
 	void renderTarget::updateViewports(VAL_PROC& proc, const std::vector<VkViewport>&viewports)
 	{
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdSetViewport(commandBuffer, 0, viewports.size(), viewports.data());
+		updateViewports(proc, viewports, 0u);
 	}
 
 	void renderTarget::updateViewports(VAL_PROC& proc, const std::vector<VkViewport>& viewports, const uint16_t startIndex) {
+		if (!countDynamicState(_boundViewports.change(startIndex, viewports.size(), viewports.data()))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
 		vkCmdSetViewport(commandBuffer, startIndex, viewports.size(), viewports.data());
 	}
 
 	void renderTarget::updateScissor(VAL_PROC& proc, const VkRect2D& scissor) {
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+		updateScissor(proc, scissor, 0u);
 	}
 
 	void renderTarget::updateScissor(VAL_PROC& proc, const VkRect2D& scissor, const uint16_t index) {
+		if (!countDynamicState(_boundScissors.change(index, 1u, &scissor))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
 		vkCmdSetScissor(commandBuffer, index, 1, &scissor);
 	}
 
 	void renderTarget::updateScissors(VAL_PROC& proc, const std::vector<VkRect2D>& scissors) {
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdSetScissor(commandBuffer, 0, scissors.size(), scissors.data());
+		updateScissors(proc, scissors, 0u);
 	}
 
 	void renderTarget::updateScissors(VAL_PROC& proc, const std::vector<VkRect2D>& scissors, const uint16_t startIndex) {
+		if (!countDynamicState(_boundScissors.change(startIndex, scissors.size(), scissors.data()))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
 		vkCmdSetScissor(commandBuffer, startIndex, scissors.size(), scissors.data());
 	}
 
 
 	void renderTarget::updateLinewidth(VAL_PROC& proc, const float lineWidth) {
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_LINE_WIDTH, _dynamicState.lineWidth, lineWidth))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
 		vkCmdSetLineWidth(commandBuffer, lineWidth);
 	}
 
 	void renderTarget::updateBlendConstants(VAL_PROC& proc, const std::array<float, 4>& depthConstants) {
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_BLEND_CONSTANTS, _dynamicState.blendConstants, depthConstants))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
 		vkCmdSetBlendConstants(commandBuffer, depthConstants.data());
 	}
 
 	void renderTarget::updateTopologyMode(VAL_PROC& proc, const TOPOLOGY_MODE topologyMode) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetPrimitiveTopology, "the primitive topology");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_TOPOLOGY, _dynamicState.topology, (VkPrimitiveTopology)topologyMode))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdSetPrimitiveTopology(commandBuffer,(VkPrimitiveTopology)topologyMode);
+		proc._vkCmdSetPrimitiveTopology(commandBuffer,(VkPrimitiveTopology)topologyMode);
 	}
 
 	void renderTarget::updateCullMode(VAL_PROC& proc, const CULL_MODE cullMode) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetCullMode, "the cull mode");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_CULL_MODE, _dynamicState.cullMode, VkCullModeFlags(cullMode)))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdSetCullMode(commandBuffer, VkCullModeFlags(cullMode));
+		proc._vkCmdSetCullMode(commandBuffer, VkCullModeFlags(cullMode));
 	}
 
 	void renderTarget::updateDepthBias(VAL_PROC& proc, const float depthBiasConstant, const float depthBiasClamp, const float depthBiasSlopeFactor) {
+		const std::array<float, 3> depthBias = { depthBiasConstant, depthBiasClamp, depthBiasSlopeFactor };
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_DEPTH_BIAS, _dynamicState.depthBias, depthBias))) {
+			return;
+		}
 		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
 		vkCmdSetDepthBias(commandBuffer, depthBiasConstant, depthBiasClamp, depthBiasSlopeFactor);
 	}
 
+	void renderTarget::updateFrontFace(VAL_PROC& proc, const VkFrontFace frontFace) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetFrontFace, "the front face");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_FRONT_FACE, _dynamicState.frontFace, frontFace))) {
+			return;
+		}
+		proc._vkCmdSetFrontFace(proc._graphicsQueue._commandBuffers[proc._currentFrame], frontFace);
+	}
+
+	void renderTarget::updateDepthTestEnable(VAL_PROC& proc, const bool enable) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetDepthTestEnable, "the depth test enable");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_DEPTH_TEST_ENABLE, _dynamicState.depthTestEnable, VkBool32(enable)))) {
+			return;
+		}
+		proc._vkCmdSetDepthTestEnable(proc._graphicsQueue._commandBuffers[proc._currentFrame], enable);
+	}
+
+	void renderTarget::updateDepthWriteEnable(VAL_PROC& proc, const bool enable) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetDepthWriteEnable, "the depth write enable");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_DEPTH_WRITE_ENABLE, _dynamicState.depthWriteEnable, VkBool32(enable)))) {
+			return;
+		}
+		proc._vkCmdSetDepthWriteEnable(proc._graphicsQueue._commandBuffers[proc._currentFrame], enable);
+	}
+
+	void renderTarget::updateDepthCompareOp(VAL_PROC& proc, const VkCompareOp compareOp) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetDepthCompareOp, "the depth compare op");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_DEPTH_COMPARE_OP, _dynamicState.depthCompareOp, compareOp))) {
+			return;
+		}
+		proc._vkCmdSetDepthCompareOp(proc._graphicsQueue._commandBuffers[proc._currentFrame], compareOp);
+	}
+
+	void renderTarget::updateDepthBoundsTestEnable(VAL_PROC& proc, const bool enable) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetDepthBoundsTestEnable, "the depth bounds test enable");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE, _dynamicState.depthBoundsTestEnable, VkBool32(enable)))) {
+			return;
+		}
+		proc._vkCmdSetDepthBoundsTestEnable(proc._graphicsQueue._commandBuffers[proc._currentFrame], enable);
+	}
+
+	void renderTarget::updateStencilTestEnable(VAL_PROC& proc, const bool enable) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetStencilTestEnable, "the stencil test enable");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_STENCIL_TEST_ENABLE, _dynamicState.stencilTestEnable, VkBool32(enable)))) {
+			return;
+		}
+		proc._vkCmdSetStencilTestEnable(proc._graphicsQueue._commandBuffers[proc._currentFrame], enable);
+	}
+
+	void renderTarget::updateStencilOp(VAL_PROC& proc, const VkStencilFaceFlags faceMask, const VkStencilOp failOp, const VkStencilOp passOp, const VkStencilOp depthFailOp, const VkCompareOp compareOp) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE(proc._vkCmdSetStencilOp, "the stencil op");
+		// the faces are cached separately, the state only has to be set if it changes for either of the faces in the mask
+		const stencilOpState stencilOp = { failOp, passOp, depthFailOp, compareOp };
+		bool changed = false;
+		if (faceMask & VK_STENCIL_FACE_FRONT_BIT) {
+			changed |= dynamicStateChanged(DYNAMIC_STATE_STENCIL_OP_FRONT, _dynamicState.stencilOps[0], stencilOp);
+		}
+		if (faceMask & VK_STENCIL_FACE_BACK_BIT) {
+			changed |= dynamicStateChanged(DYNAMIC_STATE_STENCIL_OP_BACK, _dynamicState.stencilOps[1], stencilOp);
+		}
+		if (!countDynamicState(changed)) {
+			return;
+		}
+		proc._vkCmdSetStencilOp(proc._graphicsQueue._commandBuffers[proc._currentFrame], faceMask, failOp, passOp, depthFailOp, compareOp);
+	}
+
+	void renderTarget::updateStencilReference(VAL_PROC& proc, const VkStencilFaceFlags faceMask, const uint32_t reference) {
+		bool changed = false;
+		if (faceMask & VK_STENCIL_FACE_FRONT_BIT) {
+			changed |= dynamicStateChanged(DYNAMIC_STATE_STENCIL_REFERENCE_FRONT, _dynamicState.stencilReferences[0], reference);
+		}
+		if (faceMask & VK_STENCIL_FACE_BACK_BIT) {
+			changed |= dynamicStateChanged(DYNAMIC_STATE_STENCIL_REFERENCE_BACK, _dynamicState.stencilReferences[1], reference);
+		}
+		if (!countDynamicState(changed)) {
+			return;
+		}
+		vkCmdSetStencilReference(proc._graphicsQueue._commandBuffers[proc._currentFrame], faceMask, reference);
+	}
+
+	void renderTarget::updateDepthBiasEnable(VAL_PROC& proc, const bool enable) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_2(proc._vkCmdSetDepthBiasEnable, "the depth bias enable");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_DEPTH_BIAS_ENABLE, _dynamicState.depthBiasEnable, VkBool32(enable)))) {
+			return;
+		}
+		proc._vkCmdSetDepthBiasEnable(proc._graphicsQueue._commandBuffers[proc._currentFrame], enable);
+	}
+
+	void renderTarget::updatePrimitiveRestartEnable(VAL_PROC& proc, const bool enable) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_2(proc._vkCmdSetPrimitiveRestartEnable, "the primitive restart enable");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE, _dynamicState.primitiveRestartEnable, VkBool32(enable)))) {
+			return;
+		}
+		proc._vkCmdSetPrimitiveRestartEnable(proc._graphicsQueue._commandBuffers[proc._currentFrame], enable);
+	}
+
+	void renderTarget::updateRasterizerDiscardEnable(VAL_PROC& proc, const bool enable) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_2(proc._vkCmdSetRasterizerDiscardEnable, "the rasterizer discard enable");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE, _dynamicState.rasterizerDiscardEnable, VkBool32(enable)))) {
+			return;
+		}
+		proc._vkCmdSetRasterizerDiscardEnable(proc._graphicsQueue._commandBuffers[proc._currentFrame], enable);
+	}
+
+	void renderTarget::updatePolygonMode(VAL_PROC& proc, const TOPOLOGY_MODE polygonMode) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_3(proc._vkCmdSetPolygonModeEXT, "the polygon mode");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_POLYGON_MODE, _dynamicState.polygonMode, (VkPolygonMode)polygonMode))) {
+			return;
+		}
+		proc._vkCmdSetPolygonModeEXT(proc._graphicsQueue._commandBuffers[proc._currentFrame], (VkPolygonMode)polygonMode); // VAL::TOPOLOGY_MODE maps directly to VkPolygonMode
+	}
+
+	void renderTarget::updateRasterizationSamples(VAL_PROC& proc, const VkSampleCountFlagBits samples) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_3(proc._vkCmdSetRasterizationSamplesEXT, "the rasterization samples");
+		if (!countDynamicState(dynamicStateChanged(DYNAMIC_STATE_RASTERIZATION_SAMPLES, _dynamicState.rasterizationSamples, samples))) {
+			return;
+		}
+		proc._vkCmdSetRasterizationSamplesEXT(proc._graphicsQueue._commandBuffers[proc._currentFrame], samples);
+	}
+
+	void renderTarget::updateColorBlendEnable(VAL_PROC& proc, const bool enable, const uint32_t attachment /*DEFAULT = 0u*/) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_3(proc._vkCmdSetColorBlendEnableEXT, "color blending");
+		const VkBool32 vkEnable = enable;
+		if (!countDynamicState(_boundColorBlendEnables.change(attachment, 1u, &vkEnable))) {
+			return;
+		}
+		proc._vkCmdSetColorBlendEnableEXT(proc._graphicsQueue._commandBuffers[proc._currentFrame], attachment, 1, &vkEnable);
+	}
+
+	void renderTarget::updateColorBlendEnables(VAL_PROC& proc, const std::vector<VkBool32>& enables, const uint32_t firstAttachment /*DEFAULT = 0u*/) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_3(proc._vkCmdSetColorBlendEnableEXT, "color blending");
+		if (!countDynamicState(_boundColorBlendEnables.change(firstAttachment, enables.size(), enables.data()))) {
+			return;
+		}
+		proc._vkCmdSetColorBlendEnableEXT(proc._graphicsQueue._commandBuffers[proc._currentFrame], firstAttachment, enables.size(), enables.data());
+	}
+
+	void renderTarget::updateColorBlendEquation(VAL_PROC& proc, const VkColorBlendEquationEXT& equation, const uint32_t attachment /*DEFAULT = 0u*/) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_3(proc._vkCmdSetColorBlendEquationEXT, "the color blend equation");
+		if (!countDynamicState(_boundColorBlendEquations.change(attachment, 1u, &equation))) {
+			return;
+		}
+		proc._vkCmdSetColorBlendEquationEXT(proc._graphicsQueue._commandBuffers[proc._currentFrame], attachment, 1, &equation);
+	}
+
+	void renderTarget::updateColorWriteMask(VAL_PROC& proc, const VkColorComponentFlags writeMask, const uint32_t attachment /*DEFAULT = 0u*/) {
+		VAL_VALIDATE_EXTENDED_DYNAMIC_STATE_3(proc._vkCmdSetColorWriteMaskEXT, "the color write mask");
+		if (!countDynamicState(_boundColorWriteMasks.change(attachment, 1u, &writeMask))) {
+			return;
+		}
+		proc._vkCmdSetColorWriteMaskEXT(proc._graphicsQueue._commandBuffers[proc._currentFrame], attachment, 1, &writeMask);
+	}
+
 	void renderTarget::updateBuffers(VAL_PROC& proc)
 	{
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		// bind buffers
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		}
+		bindVertexBuffers(proc);
+		bindIndexBuffer(proc);
 	}
 
 	void renderTarget::updateIndexBuffer(VAL_PROC& proc) {
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		}
+		bindIndexBuffer(proc);
 	}
 
 	void renderTarget::updateVertexBuffers(VAL_PROC& proc) {
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
+		bindVertexBuffers(proc);
 	}
 
 	/*****************************************************************************************************************************/
@@ -148,105 +438,73 @@ namespace val {
 
 	void renderTarget::updateAndSetIndexBuffer(VAL_PROC& proc, val::buffer& buffer, const uint32_t& indexCount) {
 		setIndexBuffer(buffer, indexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		};
+		bindIndexBuffer(proc);
 	}
 
 	void renderTarget::updateAndSetIndexBuffer(VAL_PROC& proc, const VkBuffer& buffer, const uint32_t& indexCount) {
 		setIndexBuffer(buffer, indexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		};
+		bindIndexBuffer(proc);
 	}
 
 
 	void renderTarget::updateAndSetVertexBuffer(VAL_PROC& proc, const VkBuffer& buffer, const uint32_t& vertexCount) {
 		setVertexBuffer(buffer, vertexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
+		bindVertexBuffers(proc);
 	}
 
 	void renderTarget::updateAndSetVertexBuffer(VAL_PROC& proc, val::buffer& buffer, const uint32_t& vertexCount) {
 		setVertexBuffer(buffer, vertexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
+		bindVertexBuffers(proc);
 	}
 
 	void renderTarget::updateAndSetVertexBuffers(VAL_PROC& proc, const std::vector<VkBuffer>& vertexBuffers, const uint32_t& vertexCount) {
 		setVertexBuffers(vertexBuffers, vertexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
+		bindVertexBuffers(proc);
 	}
 
 	void renderTarget::updateAndSetVertexBuffers(VAL_PROC& proc, const std::vector<val::buffer*>& vertexBuffers, const uint32_t& vertexCount) {
 		setVertexBuffers(vertexBuffers, vertexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
+		bindVertexBuffers(proc);
 	}
 
 	void renderTarget::updateAndSetVertexBufferAndIndexBuffer(VAL_PROC& proc, val::buffer& vertexBuffer, const uint32_t& vertexCount, val::buffer& indexBuffer, const uint32_t& indexCount) {
 		setVertexBuffer(vertexBuffer, vertexCount);
 		setIndexBuffer(indexBuffer, indexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		}
+		bindVertexBuffers(proc);
+		bindIndexBuffer(proc);
 	}
 
 	void renderTarget::updateAndSetVertexBufferAndIndexBuffer(VAL_PROC& proc, const VkBuffer& vertexBuffer, const uint32_t& vertexCount, const VkBuffer& indexBuffer, const uint32_t& indexCount) {
 		setVertexBuffer(vertexBuffer, vertexCount);
 		setIndexBuffer(indexBuffer, indexCount);
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		}
+		bindVertexBuffers(proc);
+		bindIndexBuffer(proc);
 	}
 
 	void renderTarget::updateAndSetVertexBuffersAndIndexBuffer(VAL_PROC& proc, const std::vector<val::buffer*>& vertexBuffers, const uint32_t& vertexCount, val::buffer& indexBuffer, const uint32_t& indexCount) {
 		setVertexBuffers(vertexBuffers, vertexCount);
 		setIndexBuffer(indexBuffer, indexCount);
-
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		}
+		bindVertexBuffers(proc);
+		bindIndexBuffer(proc);
 	}
 
 	void renderTarget::updateAndSetVertexBuffersAndIndexBuffer(VAL_PROC& proc, const std::vector<VkBuffer>& vertexBuffers, const uint32_t& vertexCount, const VkBuffer& indexBuffer, const uint32_t& indexCount) {
 		setVertexBuffers(vertexBuffers, vertexCount);
 		setIndexBuffer(indexBuffer, indexCount);
-
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
-		if (_indexCount > 0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		}
+		bindVertexBuffers(proc);
+		bindIndexBuffer(proc);
 	}
 	/*****************************************************************************************************************************/
 
 	void renderTarget::update(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const std::vector<VkViewport>& viewports)
 	{
-		const auto& pipelineIdx = pipeline.pipelineIdx;
-		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
-
-		// bind pipeline and respective descriptor sets
-		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, proc._graphicsPipelines[pipelineIdx]);
-		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, proc._pipelineLayouts[pipelineIdx],
-			0, 1, &proc._descriptorSets[pipelineIdx][proc._currentFrame], 0, nullptr);
+		bindPipeline(proc, pipeline, proc.getGraphicsPipeline(pipeline));
 
 		// bind buffers
-		vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBuffers.size(), _vertexBuffers.data(), _vertexBufferOffsets.data());
-		if (_indexCount>0) {
-			vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-		}
+		bindVertexBuffers(proc);
+		bindIndexBuffer(proc);
 
-		vkCmdSetViewport(commandBuffer, 0, viewports.size(), viewports.data());
+		updateViewports(proc, viewports);
 	}
 
 	void renderTarget::begin(VAL_PROC& proc)
@@ -255,6 +513,9 @@ namespace val {
 
 		vkResetCommandBuffer(commandBuffer, 0);
 
+		// descriptor sets can't be updated once they're bound by the command buffer
+		proc.flushDescriptorWrites();
+
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
@@ -262,6 +523,24 @@ namespace val {
 			throw std::runtime_error("failed to begin recording command buffer!");
 		}
 
+		// nothing is bound in a newly begun command buffer
+		invalidateBoundState();
+		_bindStats = {};
+	}
+
+	void renderTarget::invalidateBoundState() {
+		_boundPipeline = VK_NULL_HANDLE;
+		_boundPipelineLayout = VK_NULL_HANDLE;
+		invalidateDescriptorSets();
+		_boundBindlessLayout = VK_NULL_HANDLE;
+		_boundBindlessSetNo = UINT32_MAX;
+		_descriptorBufferBound = false;
+		_boundDescriptorBufferOffset = VK_WHOLE_SIZE;
+		_boundVertexBuffers.clear();
+		_boundVertexBufferOffsets.clear();
+		_boundIndexBuffer = VK_NULL_HANDLE;
+		_boundIndexBufferOffset = 0u;
+		invalidateDynamicState();
 	}
 
 	void renderTarget::beginPass(VAL_PROC& proc, VkRenderPass& renderPass, VkFramebuffer& frameBuffer) 
@@ -279,9 +558,114 @@ namespace val {
 		vkCmdEndRenderPass(proc._graphicsQueue._commandBuffers[proc._currentFrame]);
 	}
 
+	void renderTarget::beginRendering(VAL_PROC& proc, const VkRenderingAttachmentInfoKHR* colorAttachments, const uint32_t colorAttachmentCount,
+		const VkRenderingAttachmentInfoKHR* depthAttachment /*DEFAULT = NULL*/, const VkRenderingAttachmentInfoKHR* stencilAttachment /*DEFAULT = NULL*/)
+	{
+#ifndef NDEBUG
+		if (proc._vkCmdBeginRenderingKHR == NULL) {
+			dbg::printError("VAL: Attempted to use dynamic rendering, but VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME was not enabled in the physicalDeviceRequirements!\n");
+			throw std::runtime_error("VAL: DYNAMIC RENDERING IS NOT ENABLED!");
+		}
+#endif // !NDEBUG
+
+		VkRenderingInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+		renderingInfo.renderArea = _renderPassBeginInfo.renderArea;
+		renderingInfo.layerCount = 1;
+		renderingInfo.colorAttachmentCount = colorAttachmentCount;
+		renderingInfo.pColorAttachments = colorAttachments;
+		renderingInfo.pDepthAttachment = depthAttachment;
+		renderingInfo.pStencilAttachment = stencilAttachment;
+
+		proc._vkCmdBeginRenderingKHR(proc._graphicsQueue._commandBuffers[proc._currentFrame], &renderingInfo);
+	}
+
+	void renderTarget::beginRendering(VAL_PROC& proc, const VkImageView* colorViews, const uint32_t colorViewCount, VkImageView depthView /*DEFAULT = VK_NULL_HANDLE*/,
+		const VkFormat depthFormat /*DEFAULT = VK_FORMAT_UNDEFINED*/)
+	{
+		std::vector<VkRenderingAttachmentInfoKHR> colorAttachments(colorViewCount);
+		for (uint32_t i = 0; i < colorViewCount; ++i) {
+			VkRenderingAttachmentInfoKHR& attachment = colorAttachments[i];
+			attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+			attachment.imageView = colorViews[i];
+			attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			attachment.loadOp = (i < _clearValues.size()) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+			attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			if (i < _clearValues.size()) {
+				attachment.clearValue = _clearValues[i];
+			}
+		}
+
+		VkRenderingAttachmentInfoKHR depthAttachment{};
+		if (depthView != VK_NULL_HANDLE) {
+			depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+			depthAttachment.imageView = depthView;
+			depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			depthAttachment.loadOp = (colorViewCount < _clearValues.size()) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+			depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+			if (colorViewCount < _clearValues.size()) {
+				depthAttachment.clearValue = _clearValues[colorViewCount];
+			}
+		}
+
+		// a view of a depth/stencil format is both the depth and the stencil attachment, stencil only formats have no depth attachment
+		const bool hasDepthView = depthView != VK_NULL_HANDLE;
+		const VkRenderingAttachmentInfoKHR* pDepthAttachment = (hasDepthView && depthFormat != VK_FORMAT_S8_UINT) ? &depthAttachment : NULL;
+		const VkRenderingAttachmentInfoKHR* pStencilAttachment = (hasDepthView && formatHasStencil(depthFormat)) ? &depthAttachment : NULL;
+
+		beginRendering(proc, colorAttachments.data(), colorViewCount, pDepthAttachment, pStencilAttachment);
+	}
+
+	void renderTarget::beginRendering(VAL_PROC& proc, window& wnd, depthBuffer* depth /*DEFAULT = NULL*/)
+	{
+		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
+
+		// the previous contents of the swapchain image are discarded, the semaphore of the acquire is waited for before any commands execute
+		_presentImage = wnd._swapChainImages[wnd._currentSwapChainImageIndex];
+		recordImageBarrier(commandBuffer, _presentImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+		VkImageView depthView = VK_NULL_HANDLE;
+		if (depth) {
+			// waits for the depth tests of the previous frame, which used the same depth buffer
+			const VkPipelineStageFlags depthStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			// stencil only formats have no depth aspect
+			VkImageAspectFlags aspect = (depth->format == VK_FORMAT_S8_UINT) ? 0 : VK_IMAGE_ASPECT_DEPTH_BIT;
+			if (formatHasStencil(depth->format)) {
+				aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+			}
+			recordImageBarrier(commandBuffer, depth->depthImage, aspect, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				depthStages, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				depthStages, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+			// the depth buffer may have a view for every frame in flight
+			depthView = depth->imgViews[proc._currentFrame % depth->imgViews.size()];
+		}
+
+		// the render area follows the size of the swapchain, so that a resize doesn't require any changes to the render target
+		const VkRect2D renderArea = _renderPassBeginInfo.renderArea;
+		_renderPassBeginInfo.renderArea.extent = wnd._swapChainExtent;
+
+		VkImageView colorView = wnd._swapChainImageViews[wnd._currentSwapChainImageIndex];
+		beginRendering(proc, &colorView, 1u, depthView, depth ? depth->format : VK_FORMAT_UNDEFINED);
+
+		_renderPassBeginInfo.renderArea = renderArea;
+	}
+
+	void renderTarget::endRendering(VAL_PROC& proc) {
+		VkCommandBuffer& commandBuffer = proc._graphicsQueue._commandBuffers[proc._currentFrame];
+
+		proc._vkCmdEndRenderingKHR(commandBuffer);
+
+		if (_presentImage != VK_NULL_HANDLE) {
+			recordImageBarrier(commandBuffer, _presentImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+				VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+			_presentImage = VK_NULL_HANDLE;
+		}
+	}
+
 	
 	void renderTarget::submit(VAL_PROC& proc,
-		std::vector<VkSemaphore> waitSemaphores, VkFence fence /*DEFAULT=VK_NULL_HANDLE*/)
+		std::vector<VkSemaphore> waitSemaphores, VkFence fence /*DEFAULT=VK_NULL_HANDLE*/, const uploadToken uploadToWaitFor /*DEFAULT=0u*/)
 	{
 		auto& graphicsQueue = proc._graphicsQueue;
 		const auto& currentFrame = proc._currentFrame;
@@ -291,6 +675,10 @@ namespace val {
 			throw std::runtime_error("FAILED TO RECORD COMMAND BUFFER");
 		}
 
+		// the uploads of this frame are submitted ahead of the draw commands on the same queue
+		proc.flushStagingUploads();
+		proc.waitForUploadOnGPU(uploadToWaitFor);
+
 		// SUBMIT
 		VkPipelineStageFlags* waitStages = (VkPipelineStageFlags*)calloc(waitSemaphores.size(), sizeof(VkPipelineStageFlags));
 		for (size_t i = 0; i < waitSemaphores.size(); ++i) {
@@ -319,4 +707,185 @@ namespace val {
 
 		free(waitStages);
 	}
-}
\ No newline at end of file
+
+	void renderTarget::bindPipeline(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, VkPipeline vkPipeline) {
+		if (vkPipeline == _boundPipeline) {
+			++_bindStats.pipelineBindsSkipped;
+		}
+		else {
+			vkCmdBindPipeline(proc._graphicsQueue._commandBuffers[proc._currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipeline);
+			++_bindStats.pipelineBinds;
+			_boundPipeline = vkPipeline;
+			// the pipeline overwrites all the state that it doesn't declare as dynamic with it's static state
+			invalidateDynamicState();
+			// the sets bound with bindDescriptorSet belong to the previous pipeline, the new one's own sets replace them
+			std::fill(std::begin(_userBoundDescriptorSets), std::end(_userBoundDescriptorSets), false);
+		}
+
+		// every pipeline owns it's own descriptor sets, so switching to another pipeline binds it's sets again even if the layouts
+		// are compatible. Only the sets that are already bound (the same pipeline drawn again, the sets bound with bindDescriptorSet
+		// and the bindless set) are skipped
+		if (pipeline.useDescriptorBuffer) {
+			setDescriptorBufferOffset(proc, pipeline, proc._descriptorBufferOffsets[pipeline.descriptorsIdx][proc._currentFrame]);
+			return;
+		}
+
+		bindDescriptorSets(proc, pipeline, pipeline.defaultDynamicOffsets.data());
+		bindBindlessSet(proc, pipeline);
+	}
+
+	void renderTarget::bindDescriptorSets(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline, const uint32_t* dynamicOffsets) {
+		const VkPipelineLayout layout = proc._pipelineLayouts[pipeline.pipelineIdx];
+		VkDescriptorSet descriptorSets[(uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT];
+		const uint32_t setCount = proc.getDescriptorSetsToBind(pipeline, proc._currentFrame, descriptorSets);
+
+		// the sets that were bound with a compatible layout stay bound for this layout (see layoutCache::getCompatibleSetCount)
+		changeBoundPipelineLayout(proc, layout);
+
+		// the sets that were bound with bindDescriptorSet stay bound in place of the pipeline's own sets with their own dynamic offsets,
+		// until a layout that isn't compatible with them disturbs them
+		std::vector<uint32_t> userSetOffsets;
+		uint32_t setOffsetIdx = 0u;
+		for (uint32_t setNo = 0u; setNo < setCount; ++setNo) {
+			const uint32_t setOffsetCount = pipeline.setDynamicOffsetCounts[setNo];
+			if (_userBoundDescriptorSets[setNo]) {
+				if (userSetOffsets.empty()) {
+					userSetOffsets.assign(dynamicOffsets, dynamicOffsets + pipeline.defaultDynamicOffsets.size());
+				}
+				descriptorSets[setNo] = _boundDescriptorSets[setNo];
+				std::copy(_boundDynamicOffsets[setNo].begin(), _boundDynamicOffsets[setNo].end(), userSetOffsets.begin() + setOffsetIdx);
+			}
+			setOffsetIdx += setOffsetCount;
+		}
+		if (!userSetOffsets.empty()) {
+			dynamicOffsets = userSetOffsets.data();
+		}
+
+		// finds the range of sets that have changed, the sets of the lower update rates usually stay bound between draws
+		uint32_t firstSet = UINT32_MAX;
+		uint32_t lastSet = 0u;
+		uint32_t firstOffset = 0u;
+		uint32_t offsetIdx = 0u;
+		for (uint32_t setNo = 0u; setNo < setCount; ++setNo) {
+			const uint32_t setOffsetCount = pipeline.setDynamicOffsetCounts[setNo];
+			const uint32_t* setOffsets = dynamicOffsets + offsetIdx;
+			const std::vector<uint32_t>& boundOffsets = _boundDynamicOffsets[setNo];
+			if (descriptorSets[setNo] != _boundDescriptorSets[setNo] || setOffsetCount != boundOffsets.size() ||
+				!std::equal(setOffsets, setOffsets + setOffsetCount, boundOffsets.begin()))
+			{
+				if (firstSet == UINT32_MAX) {
+					firstSet = setNo;
+					firstOffset = offsetIdx;
+				}
+				lastSet = setNo;
+			}
+			offsetIdx += setOffsetCount;
+		}
+
+		if (firstSet == UINT32_MAX) {
+			++_bindStats.descriptorSetBindsSkipped;
+			return;
+		}
+
+		// the unchanged sets between the first and last changed set are bound again, so that one call is enough
+		offsetIdx = firstOffset;
+		for (uint32_t setNo = firstSet; setNo <= lastSet; ++setNo) {
+			const uint32_t setOffsetCount = pipeline.setDynamicOffsetCounts[setNo];
+			_boundDescriptorSets[setNo] = descriptorSets[setNo];
+			_boundDynamicOffsets[setNo].assign(dynamicOffsets + offsetIdx, dynamicOffsets + offsetIdx + setOffsetCount);
+			offsetIdx += setOffsetCount;
+		}
+
+		vkCmdBindDescriptorSets(proc._graphicsQueue._commandBuffers[proc._currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, layout,
+			firstSet, lastSet - firstSet + 1u, descriptorSets + firstSet, offsetIdx - firstOffset, dynamicOffsets + firstOffset);
+		++_bindStats.descriptorSetBinds;
+		_boundDescriptorBufferOffset = VK_WHOLE_SIZE;
+	}
+
+	void renderTarget::changeBoundPipelineLayout(VAL_PROC& proc, const VkPipelineLayout layout) {
+		if (layout == _boundPipelineLayout) {
+			return;
+		}
+
+		const uint32_t compatibleSetCount = proc._layoutCache.getCompatibleSetCount(layout, _boundPipelineLayout);
+		invalidateDescriptorSets(compatibleSetCount);
+		// the bindless set is disturbed too, unless the layouts are compatible up to and including it's set
+		if (_boundBindlessLayout != VK_NULL_HANDLE && compatibleSetCount <= _boundBindlessSetNo) {
+			_boundBindlessLayout = VK_NULL_HANDLE;
+		}
+		_boundPipelineLayout = layout;
+	}
+
+	void renderTarget::invalidateDescriptorSets(const uint32_t firstSetNo /*DEFAULT = 0u*/) {
+		for (uint32_t setNo = firstSetNo; setNo < (uint32_t)DESCRIPTOR_UPDATE_RATE::RATE_COUNT; ++setNo) {
+			_boundDescriptorSets[setNo] = VK_NULL_HANDLE;
+			_boundDynamicOffsets[setNo].clear();
+			_userBoundDescriptorSets[setNo] = false;
+		}
+	}
+
+	void renderTarget::bindVertexBuffers(VAL_PROC& proc) {
+		// bindings past the vertex buffers of the renderTarget may still be bound, they aren't read by the draws
+		const size_t count = _vertexBuffers.size();
+		if (count <= _boundVertexBuffers.size() &&
+			std::equal(_vertexBuffers.begin(), _vertexBuffers.end(), _boundVertexBuffers.begin()) &&
+			std::equal(_vertexBufferOffsets.begin(), _vertexBufferOffsets.end(), _boundVertexBufferOffsets.begin()))
+		{
+			++_bindStats.vertexBufferBindsSkipped;
+			return;
+		}
+
+		vkCmdBindVertexBuffers(proc._graphicsQueue._commandBuffers[proc._currentFrame], 0, count, _vertexBuffers.data(), _vertexBufferOffsets.data());
+		++_bindStats.vertexBufferBinds;
+		if (_boundVertexBuffers.size() < count) {
+			_boundVertexBuffers.resize(count);
+			_boundVertexBufferOffsets.resize(count);
+		}
+		std::copy(_vertexBuffers.begin(), _vertexBuffers.end(), _boundVertexBuffers.begin());
+		std::copy(_vertexBufferOffsets.begin(), _vertexBufferOffsets.end(), _boundVertexBufferOffsets.begin());
+	}
+
+	void renderTarget::bindIndexBuffer(VAL_PROC& proc) {
+		if (_indexCount == 0) {
+			return;
+		}
+		if (_indexBuffer == _boundIndexBuffer && _indexBufferOffset == _boundIndexBufferOffset) {
+			++_bindStats.indexBufferBindsSkipped;
+			return;
+		}
+
+		vkCmdBindIndexBuffer(proc._graphicsQueue._commandBuffers[proc._currentFrame], _indexBuffer, _indexBufferOffset, VK_INDEX_TYPE_UINT32);
+		++_bindStats.indexBufferBinds;
+		_boundIndexBuffer = _indexBuffer;
+		_boundIndexBufferOffset = _indexBufferOffset;
+	}
+
+	void renderTarget::invalidateDynamicState() {
+		_validDynamicStates = 0u;
+		_boundViewports.clear();
+		_boundScissors.clear();
+		_boundColorBlendEnables.clear();
+		_boundColorBlendEquations.clear();
+		_boundColorWriteMasks.clear();
+	}
+
+	void renderTarget::bindBindlessSet(VAL_PROC& proc, const graphicsPipelineCreateInfo& pipeline) {
+		if (pipeline.bindlessSetNo == UINT32_MAX) {
+			return;
+		}
+
+		// there's only one bindless set, it stays bound as long as the layouts that are bound after it are compatible up to it's set
+		// (see changeBoundPipelineLayout)
+		const VkPipelineLayout layout = proc._pipelineLayouts[pipeline.pipelineIdx];
+		changeBoundPipelineLayout(proc, layout);
+		if (_boundBindlessLayout != VK_NULL_HANDLE && pipeline.bindlessSetNo == _boundBindlessSetNo) {
+			++_bindStats.descriptorSetBindsSkipped;
+			return;
+		}
+
+		proc._bindless.bind(proc._graphicsQueue._commandBuffers[proc._currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, layout, pipeline.bindlessSetNo);
+		++_bindStats.descriptorSetBinds;
+		_boundBindlessLayout = layout;
+		_boundBindlessSetNo = pipeline.bindlessSetNo;
+	}
+}
@@ -0,0 +1,109 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <VAL/lib/system/shaderModuleCache.hpp>
+#include <VAL/lib/debugReporting/debugCallbacks.hpp>
+
+#include <stdexcept>
+#include <cstring>
+
+namespace val {
+
+	void shaderModuleCache::create(VkDevice device) {
+		_device = device;
+	}
+
+	void shaderModuleCache::destroy() {
+		if (!_device) {
+			return;
+		}
+
+		for (auto& [hash, cached] : _modules) {
+			vkDestroyShaderModule(_device, cached.module, NULL);
+		}
+		_modules.clear();
+
+		_device = VK_NULL_HANDLE;
+	}
+
+	VkShaderModule shaderModuleCache::acquire(const shaderModuleKey& key, const char* bytecode, const size_t bytecodeSize) {
+		auto it = _modules.find(key);
+		if (it != _modules.end()) {
+			++it->second.refCount;
+			return it->second.module;
+		}
+
+		if (bytecodeSize == 0u) {
+			dbg::printError("VAL: The bytecode of a shader was deleted before it's shader module was created!\n");
+			throw std::runtime_error("VAL: THE BYTECODE OF A SHADER WAS DELETED BEFORE IT'S SHADER MODULE WAS CREATED!");
+		}
+
+		VkShaderModuleCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = bytecodeSize;
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(bytecode);
+
+		cachedModule cached;
+		if (vkCreateShaderModule(_device, &createInfo, NULL, &cached.module) != VK_SUCCESS) {
+			throw std::runtime_error("FAILED TO CREATE VK SHADER MODULE");
+		}
+		cached.refCount = 1u;
+
+		_modules.emplace(key, cached);
+		return cached.module;
+	}
+
+	bool shaderModuleCache::release(VkShaderModule module) {
+		for (auto it = _modules.begin(); it != _modules.end(); ++it) {
+			if (it->second.module != module) {
+				continue;
+			}
+
+			if (--it->second.refCount == 0u) {
+				vkDestroyShaderModule(_device, module, NULL);
+				_modules.erase(it);
+				return true;
+			}
+			return false;
+		}
+		return false;
+	}
+
+	shaderModuleKey shaderModuleCache::hashByteCode(const char* bytecode, const size_t bytecodeSize) {
+		shaderModuleKey key;
+		key.size = bytecodeSize;
+
+		key.hash = 14695981039346656037ull;
+		for (size_t i = 0; i < bytecodeSize; ++i) {
+			key.hash ^= (uint8_t)bytecode[i];
+			key.hash *= 1099511628211ull;
+		}
+
+		// the second hash uses an unrelated function, so that a collision of both is practically impossible.
+		// SPIR-V is a stream of 32 bit words, any trailing bytes are mixed in as a partial word
+		key.hash2 = 0x27d4eb2f165667c5ull ^ bytecodeSize;
+		for (size_t i = 0; i < bytecodeSize; i += 4u) {
+			uint32_t word = 0u;
+			memcpy(&word, bytecode + i, (bytecodeSize - i < 4u) ? (bytecodeSize - i) : 4u);
+			key.hash2 ^= word;
+			key.hash2 *= 0xff51afd7ed558ccdull;
+			key.hash2 ^= key.hash2 >> 33;
+		}
+		return key;
+	}
+}
@@ -0,0 +1,268 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/stagingRing.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+#include <stdexcept>
+#include <cstring>
+#include <algorithm>
+
+namespace val {
+
+	// the stages and accesses of the work that reads or writes the buffers that the ring copies into
+	static constexpr VkPipelineStageFlags CONSUMER_STAGES = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+		VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	static constexpr VkAccessFlags CONSUMER_ACCESS = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+		VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	void stagingRing::create(VAL_PROC& proc, const uint8_t frameCount, const VkDeviceSize frameSize /*DEFAULT = VAL_STAGING_RING_FRAME_SIZE*/) {
+		_proc = &proc;
+		_frameSize = frameSize;
+
+		// one buffer is shared between all the regions, region n begins at n * frameSize
+		_proc->createBuffer(_frameSize * frameCount * 2u, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _buffer, _memory);
+
+		_regions.resize(size_t(frameCount) * 2u);
+		_currentRegions.assign(frameCount, 0u);
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = _proc->_commandPool;
+		allocInfo.commandBufferCount = 1;
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		for (size_t i = 0; i < _regions.size(); ++i) {
+			frameRegion& region = _regions[i];
+			region.base = VkDeviceSize(i) * _frameSize;
+			if (vkAllocateCommandBuffers(_proc->_device, &allocInfo, &region.commandBuffer) != VK_SUCCESS) {
+				throw std::runtime_error("VAL: failed to allocate staging ring command buffer!");
+			}
+			if (vkCreateFence(_proc->_device, &fenceInfo, NULL, &region.fence) != VK_SUCCESS) {
+				throw std::runtime_error("VAL: failed to create staging ring fence!");
+			}
+		}
+	}
+
+	void stagingRing::destroy() {
+		if (!isCreated()) {
+			return;
+		}
+
+		waitIdle();
+
+		for (frameRegion& region : _regions) {
+			vkFreeCommandBuffers(_proc->_device, _proc->_commandPool, 1, &region.commandBuffer);
+			vkDestroyFence(_proc->_device, region.fence, NULL);
+		}
+		_regions.clear();
+		_currentRegions.clear();
+
+		_proc->destroyBuffer(_buffer, _memory);
+		_proc = NULL;
+	}
+
+	bool stagingRing::queueCopy(const uint8_t frameIdx, const void* data, const VkDeviceSize size, const VkBuffer* dstBuffers, const uint32_t dstBufferCount, const VkDeviceSize dstOffset) {
+		VkDeviceSize ringOffset;
+		if (!stage(frameIdx, data, size, ringOffset)) {
+			return false;
+		}
+
+		frameRegion& region = getRecordingRegion(frameIdx);
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = ringOffset;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+		for (uint32_t i = 0; i < dstBufferCount; ++i) {
+			vkCmdCopyBuffer(region.commandBuffer, _buffer, dstBuffers[i], 1, &copyRegion);
+			region.dstBuffers.push_back(dstBuffers[i]);
+		}
+
+		return true;
+	}
+
+	bool stagingRing::queueCopy(const uint8_t frameIdx, const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize* dstOffsets, const uint32_t dstOffsetCount) {
+		VkDeviceSize ringOffset;
+		if (!stage(frameIdx, data, size, ringOffset)) {
+			return false;
+		}
+
+		frameRegion& region = getRecordingRegion(frameIdx);
+
+		std::vector<VkBufferCopy> copyRegions(dstOffsetCount);
+		for (uint32_t i = 0; i < dstOffsetCount; ++i) {
+			copyRegions[i].srcOffset = ringOffset;
+			copyRegions[i].dstOffset = dstOffsets[i];
+			copyRegions[i].size = size;
+		}
+		vkCmdCopyBuffer(region.commandBuffer, _buffer, dstBuffer, dstOffsetCount, copyRegions.data());
+		region.dstBuffers.push_back(dstBuffer);
+
+		return true;
+	}
+
+	void stagingRing::queueBufferCopy(const uint8_t frameIdx, VkBuffer srcBuffer, VkBuffer dstBuffer, const VkBufferCopy* regions, const uint32_t regionCount) {
+		frameRegion& region = getRecordingRegion(frameIdx);
+
+		vkCmdCopyBuffer(region.commandBuffer, srcBuffer, dstBuffer, regionCount, regions);
+		region.dstBuffers.push_back(dstBuffer);
+	}
+
+	void stagingRing::flush(const uint8_t frameIdx) {
+		if (!isCreated()) {
+			return;
+		}
+
+		frameRegion& region = _regions[size_t(frameIdx) * 2u + _currentRegions[frameIdx]];
+		if (!region.recording) {
+			return;
+		}
+
+		submit(region);
+	}
+
+	void stagingRing::waitIdle() {
+		for (uint8_t i = 0; i < _currentRegions.size(); ++i) {
+			flush(i);
+		}
+		for (frameRegion& region : _regions) {
+			reclaim(region);
+		}
+	}
+
+	bool stagingRing::hasQueuedCopies(const uint8_t frameIdx) const {
+		return isCreated() && _regions[size_t(frameIdx) * 2u + _currentRegions[frameIdx]].recording;
+	}
+
+	void stagingRing::waitForBuffer(VkBuffer buffer) {
+		for (frameRegion& region : _regions) {
+			if (std::find(region.dstBuffers.begin(), region.dstBuffers.end(), buffer) != region.dstBuffers.end()) {
+				if (region.recording) {
+					submit(region);
+				}
+				reclaim(region);
+			}
+		}
+	}
+
+	VkDeviceSize stagingRing::getFrameSize() const {
+		return _frameSize;
+	}
+
+	void stagingRing::reclaim(frameRegion& region) {
+		if (region.inFlight) {
+			vkWaitForFences(_proc->_device, 1, &region.fence, VK_TRUE, UINT64_MAX);
+			vkResetFences(_proc->_device, 1, &region.fence);
+			region.inFlight = false;
+		}
+		region.head = 0u;
+		region.dstBuffers.clear();
+	}
+
+	stagingRing::frameRegion& stagingRing::getRecordingRegion(const uint8_t frameIdx) {
+		frameRegion* region = &_regions[size_t(frameIdx) * 2u + _currentRegions[frameIdx]];
+		if (region->recording) {
+			return *region;
+		}
+
+		// the copies that are queued while the region is in flight go into the other region of the frame,
+		// which only stalls if that one hasn't completed yet either
+		if (region->inFlight) {
+			_currentRegions[frameIdx] ^= 1u;
+			region = &_regions[size_t(frameIdx) * 2u + _currentRegions[frameIdx]];
+		}
+		reclaim(*region);
+		beginRecording(*region);
+		return *region;
+	}
+
+	bool stagingRing::stage(const uint8_t frameIdx, const void* data, const VkDeviceSize size, VkDeviceSize& ringOffsetOut) {
+		if (size > _frameSize) {
+			return false;
+		}
+
+		frameRegion* region = &getRecordingRegion(frameIdx);
+
+		VkDeviceSize offset = (region->head + VAL_STAGING_RING_ALIGNMENT - 1) & ~(VAL_STAGING_RING_ALIGNMENT - 1);
+		if (offset + size > _frameSize) {
+			// the region is full, it's submitted and the copies continue in the other region of the frame.
+			// This only stalls if that region is still in flight, if it happens regularly VAL_STAGING_RING_FRAME_SIZE should be increased.
+			submit(*region);
+			region = &getRecordingRegion(frameIdx);
+			offset = 0u;
+		}
+
+		ringOffsetOut = region->base + offset;
+		memcpy((char*)_memory.mapped + ringOffsetOut, data, (size_t)size);
+		region->head = offset + size;
+
+		return true;
+	}
+
+	void stagingRing::beginRecording(frameRegion& region) {
+		vkResetCommandBuffer(region.commandBuffer, 0);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (vkBeginCommandBuffer(region.commandBuffer, &beginInfo) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to begin recording staging ring command buffer!");
+		}
+
+		// the destination buffers may still be read or written by work that was submitted before the copies
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = CONSUMER_ACCESS;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(region.commandBuffer, CONSUMER_STAGES, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 1, &barrier, 0, NULL, 0, NULL);
+
+		region.recording = true;
+	}
+
+	void stagingRing::submit(frameRegion& region) {
+		// make the copies visible to the work that is submitted after them
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = CONSUMER_ACCESS;
+		vkCmdPipelineBarrier(region.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, CONSUMER_STAGES,
+			0, 1, &barrier, 0, NULL, 0, NULL);
+
+		if (vkEndCommandBuffer(region.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to record staging ring command buffer!");
+		}
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &region.commandBuffer;
+
+		if (vkQueueSubmit(_proc->_graphicsQueue._queue, 1, &submitInfo, region.fence) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to submit staging ring command buffer!");
+		}
+
+		region.recording = false;
+		region.inFlight = true;
+	}
+}
@@ -0,0 +1,221 @@
+/*
+Copyright © 2025 Tripp Robins
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this
+software and associated documentation files (the “Software”), to deal in the Software
+without restriction, including without limitation the rights to use, copy, modify, merge,
+publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <VAL/lib/system/uploadBatch.hpp>
+#include <VAL/lib/system/VAL_PROC.hpp>
+
+#include <stdexcept>
+#include <cstring>
+#include <numeric>
+
+namespace val {
+
+	void uploadBatch::copyToBuffer(const void* data, const VkDeviceSize size, VkBuffer dstBuffer, const VkDeviceSize dstOffset /*DEFAULT = 0u*/) {
+		VkDeviceSize srcOffset;
+		VkBuffer srcBuffer = stage(data, size, srcOffset);
+
+		copyBuffer(srcBuffer, dstBuffer, size, srcOffset, dstOffset);
+	}
+
+	void uploadBatch::copyToImage(const void* data, const VkDeviceSize size, VkImage dstImage, const uint32_t width, const uint32_t height,
+		const uint32_t mipLevel /*DEFAULT = 0u*/, const VkImageAspectFlags aspect /*DEFAULT = VK_IMAGE_ASPECT_COLOR_BIT*/)
+	{
+#ifndef NDEBUG
+		if (height == 0 or width == 0) {
+			dbg::printError("Copying data to an image with a width or height of zero is invalid!\n");
+		}
+#endif // !NDEBUG
+
+		// the texels are tightly packed, so the texel size follows from the size of the data.
+		// The offset of a buffer to image copy must be a multiple of the texel size, which isn't a power of two for 3 or 12 byte formats
+		const VkDeviceSize texelSize = size / (VkDeviceSize(width) * height);
+
+		VkDeviceSize srcOffset;
+		VkBuffer srcBuffer = stage(data, size, srcOffset, texelSize ? std::lcm(VkDeviceSize(16u), texelSize) : VkDeviceSize(16u));
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = srcOffset;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = aspect;
+		region.imageSubresource.mipLevel = mipLevel;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { width, height, 1 };
+
+		vkCmdCopyBufferToImage(getVkCommandBuffer(), srcBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	}
+
+	void uploadBatch::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, const VkDeviceSize size, const VkDeviceSize srcOffset /*DEFAULT = 0u*/, const VkDeviceSize dstOffset /*DEFAULT = 0u*/) {
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(getVkCommandBuffer(), srcBuffer, dstBuffer, 1, &copyRegion);
+	}
+
+	void uploadBatch::transitionImageLayout(VkImage image, const VkFormat format, const VkImageLayout oldLayout, const VkImageLayout newLayout, const uint32_t mipLevels /*DEFAULT = 1u*/) {
+		_proc.transitionImageLayout(image, format, oldLayout, newLayout, getVkCommandBuffer(), mipLevels);
+	}
+
+	void uploadBatch::generateMipMaps(VkImage image, const VkFormat format, const int32_t width, const int32_t height, const uint32_t mipLevels) {
+		_proc.generateMipMaps(image, format, width, height, mipLevels, getVkCommandBuffer());
+	}
+
+	void uploadBatch::memoryBarrier(const VkPipelineStageFlags srcStage, const VkAccessFlags srcAccess, const VkPipelineStageFlags dstStage, const VkAccessFlags dstAccess) {
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstAccessMask = dstAccess;
+		vkCmdPipelineBarrier(getVkCommandBuffer(), srcStage, dstStage, 0, 1, &barrier, 0, NULL, 0, NULL);
+	}
+
+	VkCommandBuffer uploadBatch::getVkCommandBuffer() {
+		beginRecording();
+		return _commandBuffer;
+	}
+
+	void uploadBatch::submit() {
+		if (!_recording) {
+			return;
+		}
+
+		if (vkEndCommandBuffer(_commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to record upload batch command buffer!");
+		}
+
+		// uploads that were queued in the staging ring have to execute first, the batch may read from their destinations
+		_proc.flushStagingUploads();
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &_commandBuffer;
+
+		if (vkQueueSubmit(_proc._graphicsQueue._queue, 1, &submitInfo, _fence) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to submit upload batch command buffer!");
+		}
+
+		_recording = false;
+		_submitted = true;
+	}
+
+	void uploadBatch::wait() {
+		if (_submitted) {
+			vkWaitForFences(_proc._device, 1, &_fence, VK_TRUE, UINT64_MAX);
+			vkResetFences(_proc._device, 1, &_fence);
+			_submitted = false;
+		}
+
+		if (_recording) {
+			return;
+		}
+
+		for (stagingBuffer& staging : _stagingBuffers) {
+			_proc.destroyBuffer(staging.buffer, staging.memory);
+		}
+		_stagingBuffers.clear();
+	}
+
+	void uploadBatch::submitAndWait() {
+		submit();
+		wait();
+	}
+
+	void uploadBatch::destroy() {
+		submitAndWait();
+
+		if (_commandBuffer) {
+			vkFreeCommandBuffers(_proc._device, _proc._commandPool, 1, &_commandBuffer);
+			_commandBuffer = VK_NULL_HANDLE;
+		}
+		if (_fence) {
+			vkDestroyFence(_proc._device, _fence, NULL);
+			_fence = VK_NULL_HANDLE;
+		}
+	}
+
+	void uploadBatch::beginRecording() {
+		if (_recording) {
+			return;
+		}
+
+		// the command buffer and it's staging buffers are still in use by the previous submission
+		wait();
+
+		if (!_commandBuffer) {
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandPool = _proc._commandPool;
+			allocInfo.commandBufferCount = 1;
+
+			if (vkAllocateCommandBuffers(_proc._device, &allocInfo, &_commandBuffer) != VK_SUCCESS) {
+				throw std::runtime_error("VAL: failed to allocate upload batch command buffer!");
+			}
+
+			VkFenceCreateInfo fenceInfo{};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+			if (vkCreateFence(_proc._device, &fenceInfo, NULL, &_fence) != VK_SUCCESS) {
+				throw std::runtime_error("VAL: failed to create upload batch fence!");
+			}
+		}
+		else {
+			vkResetCommandBuffer(_commandBuffer, 0);
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (vkBeginCommandBuffer(_commandBuffer, &beginInfo) != VK_SUCCESS) {
+			throw std::runtime_error("VAL: failed to begin recording upload batch command buffer!");
+		}
+
+		_recording = true;
+	}
+
+	VkBuffer uploadBatch::stage(const void* data, const VkDeviceSize size, VkDeviceSize& offsetOut, const VkDeviceSize alignment /*DEFAULT = 16u*/) {
+		// staging buffers can't be reused until the previous submission has completed
+		beginRecording();
+
+		if (!_stagingBuffers.empty()) {
+			stagingBuffer& current = _stagingBuffers.back();
+			const VkDeviceSize offset = (current.head + alignment - 1) / alignment * alignment;
+			if (offset + size <= VAL_UPLOAD_BATCH_STAGING_SIZE) {
+				memcpy((char*)current.memory.mapped + offset, data, (size_t)size);
+				current.head = offset + size;
+				offsetOut = offset;
+				return current.buffer;
+			}
+		}
+
+		stagingBuffer staging;
+		const VkDeviceSize stagingSize = size > VAL_UPLOAD_BATCH_STAGING_SIZE ? size : VAL_UPLOAD_BATCH_STAGING_SIZE;
+		_proc.createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			staging.buffer, staging.memory);
+
+		memcpy(staging.memory.mapped, data, (size_t)size);
+		staging.head = size;
+		offsetOut = 0u;
+
+		_stagingBuffers.push_back(staging);
+		return staging.buffer;
+	}
+}
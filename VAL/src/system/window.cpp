@@ -137,7 +137,10 @@ namespace val {
 
 		createSwapChain(swapchainFormat);
 		createSwapChainImageViews(swapchainFormat);
-		createSwapChainFrameBuffers(_swapChainExtent, _swapChainAttachments, _swapChainAttachmentCount, _swapChainRenderPass, _procVAL->_device);
+		// with dynamic rendering there are no framebuffers to recreate
+		if (_swapChainRenderPass != VK_NULL_HANDLE) {
+			createSwapChainFrameBuffers(_swapChainExtent, _swapChainAttachments, _swapChainAttachmentCount, _swapChainRenderPass, _procVAL->_device);
+		}
 		//_procFML->createFrameBuffers(_swapChainExtent);
 		//createSyncObjects();
 	}
@@ -235,23 +238,24 @@ namespace val {
 		vkWaitForFences(_procVAL->_device, 1, &_presentQueue._fences[_procVAL->_currentFrame], VK_TRUE, UINT64_MAX);
 	}
 
-	VkFramebuffer& window::getSwapchainFramebuffer(const VkFormat& imageFormat) {
-		//vkWaitForFences(_procVAL->_device, 1, &_presentQueue._fences[_procVAL->_currentFrame], VK_TRUE, UINT64_MAX);
-
-		//uint32_t imageIndex;
+	uint32_t window::acquireNextImage(const VkFormat& imageFormat) {
 		VkResult result = vkAcquireNextImageKHR(_procVAL->_device, _swapChain, UINT64_MAX,
 			_presentQueue._semaphores[_procVAL->_currentFrame], VK_NULL_HANDLE, &_currentSwapChainImageIndex);
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			vkDeviceWaitIdle(_procVAL->_device);
 			recreateSwapChain(imageFormat);
-			return _swapChainFrameBuffers[_currentSwapChainImageIndex];
+			return _currentSwapChainImageIndex;
 		}
 		else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
 			throw std::runtime_error("VAL: Failed to acquire swap chain image!");
 		}
 
-		return _swapChainFrameBuffers[_currentSwapChainImageIndex];
+		return _currentSwapChainImageIndex;
+	}
+
+	VkFramebuffer& window::getSwapchainFramebuffer(const VkFormat& imageFormat) {
+		return _swapChainFrameBuffers[acquireNextImage(imageFormat)];
 	}
 
 	// returns a swapchain frame buffer to use
@@ -260,4 +264,10 @@ namespace val {
 		VkFramebuffer& framebuffer = getSwapchainFramebuffer(imageFormat); // gets the swapchain framebuffer to be rendered to
 		return framebuffer;
 	}
+
+	// returns the index of the swapchain image to render to
+	uint32_t window::beginDrawImage(const VkFormat& imageFormat) {
+		vkResetFences(_procVAL->_device, 1, &_presentQueue._fences[_procVAL->_currentFrame]);
+		return acquireNextImage(imageFormat);
+	}
 }
\ No newline at end of file